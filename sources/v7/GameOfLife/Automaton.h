@@ -2,28 +2,1319 @@
 #define GAME_OF_LIFE_AUTOMATON_H_
 
 #include "bootstrap.h"
+#include "Boundary.h"
+#include "Neighbourhood.h"
+#include "Rule.h"
+#include "Soup.h"
 
+template <uint8_t W, uint8_t H, class Boundary, class Kernel = Moore>
 class Automaton
 {
     private:
 
-        uint8_t grid[W+2][H+2];
+        // la grille visible est rangée ligne par ligne, sans frange
+        static const size_t STRIDE = W;
+        static const uint8_t TILES_X = (W + 7) / 8;
+        static const uint8_t TILES_Y = (H + 7) / 8;
 
-        uint8_t duplicate(uint8_t g);
-        uint8_t neighbours(size_t x, size_t y);
-        void bufferize();
-        void applyRules();
+        uint8_t grid[STRIDE*H];
+        // la grille est découpée en tuiles de 8x8 cellules (1 bit par
+        // tuile) : seules les tuiles actives, dont une cellule ou une
+        // cellule voisine a changé lors de la dernière génération, sont
+        // évaluées
+        uint32_t active[TILES_Y];
+        uint32_t changed[TILES_Y];
+        // cellules changées, rangée par rangée : un octet par tuile, dont le
+        // bit i est la colonne i de la tuile
+        uint8_t dirty[H][TILES_X];
+        // table de transition : 1 bit par configuration du voisinage 3x3 ;
+        // sur une grille hexagonale, les voisines d'une rangée dépendent de
+        // sa parité, et chaque parité a sa table
+        static const uint8_t PARITIES = Kernel::HEX ? 2 : 1;
+        uint8_t table[PARITIES][64];
+        // masques de la règle (naissance, survie), indexés par le nombre de
+        // voisins, pour les noyaux qui le comptent
+        uint16_t conditions[2];
+        // nouvel état d'une cellule selon son état courant,
+        // suivant qu'elle est vivante ou non à la génération suivante
+        uint8_t transition[2][16];
+        // masque des états « actifs », pris en compte comme voisins
+        uint16_t firing;
+        uint8_t states;
+        // B3/S23 dispose de son propre noyau de calcul
+        bool conway;
+        // rectangle [left,right[ x [top,bottom[ contenant toutes les cellules
+        // non vides (vide si left == right) ; avec B0, une cellule peut
+        // naître sans voisin et le rectangle couvre alors toute la grille
+        uint8_t left, top, right, bottom;
+        bool bounded;
+        // mode creux, tant que la population est faible : seules les
+        // cellules non vides (live) sont parcourues, et chacune dépose
+        // son bit dans la configuration 3x3 de ses voisines, accumulée
+        // dans une table de hachage à adressage ouvert (keys, configs),
+        // dont les SLOTS cases suffisent aux 9 x SPARSE_MAX voisines au
+        // plus, et dont les cases occupées sont listées (filled, de taille
+        // touched) ; on y entre à SPARSE_IN cellules ou moins, on en sort
+        // au-delà de SPARSE_MAX, et la population n'est recensée que
+        // toutes les CENSUS générations en mode dense ; la grille reste
+        // la mémoire des cellules, que lisent les vues et l'éditeur
+        static const uint8_t SPARSE_IN = 24;
+        static const uint8_t SPARSE_MAX = 48;
+        static const uint16_t SLOTS = 512;
+        static const uint8_t CENSUS = 8;
+        bool sparse;
+        uint8_t census;
+        uint8_t population;
+        uint16_t touched;
+        uint16_t live[SPARSE_MAX];
+        // règles Larger than Life (large) : portée et forme du voisinage,
+        // et intervalles du nombre de voisins pour naître ou survivre ;
+        // les rangées lues sont encadrées de MARGIN cellules, soit la
+        // portée maximale plus une, et RING rangées suffisent à couvrir le
+        // voisinage et la rangée qui le précède
+        static const uint8_t MARGIN = Rule::MAX_RADIUS + 1;
+        static const size_t SPAN = W + 2*MARGIN;
+        static const uint8_t RING = 2*Rule::MAX_RADIUS + 2;
+        bool large;
+        bool diamond;
+        uint8_t radius;
+        uint8_t birthMin, birthMax;
+        uint8_t survivalMin, survivalMax;
+        // topologie courante (identifiant d'une politique de Boundary.h),
+        // et prolongement de ses colonnes et rangées au-delà du bord
+        uint8_t topology, columns, rows;
+        // génération en cours (pending), que stepRows() calcule par tranches
+        // de rangées : plage [x0,x1[ x [y0,y1[ à évaluer et prochaine rangée
+        // (line) ; fenêtre glissante sur trois rangées de la génération
+        // précédente (above, current et below, dans window), rangée qui
+        // prolonge la dernière (first), lue avant que la génération ne
+        // l'écrase, et tuiles actives de la génération suivante (next)
+        bool pending;
+        uint8_t x0, x1, y0, y1, line;
+        // le mode creux n'a jamais de génération en cours : sa table de
+        // hachage occupe la mémoire de la fenêtre ; les règles Larger than
+        // Life, calculées d'un bloc et jamais en mode creux, y placent
+        // leurs rangées glissantes (ring, voir advanceSquare() et
+        // advanceDiamond()), celles qui prolongent la dernière (tail), et
+        // une rangée de travail (strip)
+        union {
+            struct {
+                uint8_t window[3][W+2];
+                uint8_t first[W+2];
+            };
+            struct {
+                uint16_t keys[SLOTS];
+                uint16_t configs[SLOTS];
+                uint16_t filled[9*SPARSE_MAX];
+            };
+            struct {
+                uint8_t ring[2][RING][SPAN];
+                uint8_t tail[Rule::MAX_RADIUS][SPAN];
+                uint8_t strip[SPAN];
+            };
+        };
+        uint8_t* above;
+        uint8_t* current;
+        uint8_t* below;
+        uint32_t next[TILES_Y];
+
+        template <class T> void use();
+        uint8_t locate(size_t& x, size_t& y);
+        uint8_t* cell(size_t x, size_t y);
+        uint8_t state(uint8_t g);
+        void buildTables(uint16_t birth, uint16_t survival);
+        void buildTransitions(uint8_t states);
+        void activate(size_t x, size_t y);
+        void activateAll();
+        void mark(size_t x, size_t y);
+        void include(size_t x, size_t y);
+        bool isEmpty(size_t x, size_t y, size_t xsup, size_t ysup);
+        void shrink();
+        void densify();
+        bool sparsify();
+        uint16_t slot(uint16_t c);
+        void stepSparse();
+        void spread(uint32_t* next, size_t y, const uint32_t* changes);
+        template <class T> void load(size_t y, uint8_t* buffer, bool flip);
+        uint8_t column(const uint8_t* a, const uint8_t* c, const uint8_t* b);
+        uint8_t count(const uint8_t* a, const uint8_t* c, const uint8_t* b);
+        void applyRules(const uint8_t* a, const uint8_t* c, const uint8_t* b, uint8_t* r, size_t x, size_t xsup, uint32_t* changes, uint8_t* cells);
+        void applyConway(const uint8_t* a, const uint8_t* c, const uint8_t* b, uint8_t* r, size_t x, size_t xsup, uint32_t* changes, uint8_t* cells);
+        void applyCounts(const uint8_t* a, const uint8_t* c, const uint8_t* b, uint8_t* r, size_t x, size_t xsup, uint32_t* changes, uint8_t* cells, int8_t side);
+        template <class T> bool advance(uint8_t rows);
+        void conclude(size_t xlo, size_t xhi, size_t ylo, size_t yhi);
+        template <class T> void prepareTiles(size_t xlo, size_t xhi, size_t ylo, size_t yhi);
+        template <class T> bool widen(uint8_t d, size_t& xlo, size_t& xhi, size_t& ylo, size_t& yhi);
+        template <class T> bool advanceTiles(uint8_t rows);
+        template <class T> void loadWide(int16_t y, uint8_t* buffer);
+        uint8_t evolve(uint8_t g, uint8_t n);
+        template <class T> void advanceSquare(size_t xlo, size_t xhi, size_t ylo, size_t yhi);
+        template <class T> void advanceDiamond(size_t xlo, size_t xhi, size_t ylo, size_t yhi);
 
     public:
 
+        static const uint8_t WIDTH  = W;
+        static const uint8_t HEIGHT = H;
+        static const uint8_t TILE   = 8;
+        typedef Boundary Topology;
+        typedef Kernel Neighbourhood;
+
         Automaton();
+        bool setRule(const char* rulestring);
+        bool setTopology(uint8_t id);
         uint8_t getCell(size_t x, size_t y);
+        uint32_t getChangedTiles(uint8_t ty);
+        uint8_t getChangedCells(uint8_t y, uint8_t tx);
+        void getBounds(uint8_t& x, uint8_t& y, uint8_t& xsup, uint8_t& ysup);
+        bool pan(int8_t dx, int8_t dy);
         void spawn(size_t x, size_t y);
         void kill(size_t x, size_t y);
         void clear();
-        void randomize();
+        void randomize(Soup& soup);
         void addPattern(const uint8_t* pattern, uint8_t x, uint8_t y);
         void step();
+        void step(uint16_t n);
+        bool stepRows(uint8_t rows);
+        bool isPending();
 };
 
-#endif
\ No newline at end of file
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+Automaton<W,H,Boundary,Kernel>::Automaton() : states(0), left(0), top(0), right(W), bottom(H), bounded(true), sparse(false), large(false), pending(false) {
+    this->template use<Boundary>();
+    this->clear();
+    this->setRule(Rule::CONWAY);
+}
+
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+bool Automaton<W,H,Boundary,Kernel>::setRule(const char* rulestring) {
+    Rule rule;
+    uint8_t* c;
+    uint8_t* csup = this->grid + STRIDE*H;
+    if (!rule.parse(rulestring) || (rule.getNeighbourhood() && rule.getNeighbourhood() != Kernel::ID)) {
+        return false;
+    }
+    // les lettres de Hensel et les grandes portées supposent le voisinage
+    // de Moore
+    if (Kernel::ID != Moore::ID && (rule.isLarge() || !rule.isTotalistic())) {
+        return false;
+    }
+    // en changeant de famille de règles, les âges ou les états de déclin
+    // n'ont plus de sens : les cellules non vides redeviennent actives
+    if (rule.getStates() != this->states) {
+        for (c=this->grid; c<csup; c++) {
+            *c = *c != 0;
+        }
+    }
+    this->states = rule.getStates();
+    this->firing = this->states > 2 ? 1 << 1 : 0xFFFE;
+    if (Kernel::ID == Moore::ID) {
+        memcpy(this->table[0], rule.getTable(), sizeof(this->table[0]));
+    } else {
+        this->buildTables(rule.getBirth(), rule.getSurvival());
+    }
+    this->conditions[0] = rule.getBirth();
+    this->conditions[1] = rule.getSurvival();
+    this->buildTransitions(this->states);
+    this->conway = rule.isConway();
+    this->bounded = !(rule.getBirth() & 1);
+    this->large = rule.isLarge();
+    this->diamond = rule.isVonNeumann();
+    this->radius = rule.getRadius();
+    rule.getBirthRange(this->birthMin, this->birthMax);
+    rule.getSurvivalRange(this->survivalMin, this->survivalMax);
+    this->activateAll();
+    // le mode creux ne connaît que le voisinage 3x3
+    if (!this->bounded || this->large) {
+        this->densify();
+    }
+    return true;
+}
+
+// change de topologie sans toucher aux cellules : toutes les tuiles sont
+// réévaluées, puisque le voisinage des bords n'est plus le même
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+bool Automaton<W,H,Boundary,Kernel>::setTopology(uint8_t id) {
+    switch (id) {
+        case Torus::ID:       this->template use<Torus>();       break;
+        case KleinBottle::ID: this->template use<KleinBottle>(); break;
+        case Cylinder::ID:    this->template use<Cylinder>();    break;
+        case DeadBorder::ID:  this->template use<DeadBorder>();  break;
+        case Mirror::ID:      this->template use<Mirror>();      break;
+        default:
+            return false;
+    }
+    this->activateAll();
+    return true;
+}
+
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+template <class T>
+void Automaton<W,H,Boundary,Kernel>::use() {
+    this->topology = T::ID;
+    this->columns = T::COLUMNS;
+    this->rows = T::ROWS;
+}
+
+// état à inscrire pour une cellule créée avec l'âge g : avec les règles
+// Generations, toute cellule créée est active
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+uint8_t Automaton<W,H,Boundary,Kernel>::state(uint8_t g) {
+    return this->states > 2 ? g != 0 : g;
+}
+
+// tables des voisinages autres que Moore, où seules les voisines
+// désignées par Kernel sont comptées
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::buildTables(uint16_t birth, uint16_t survival) {
+    uint16_t i,k,mask;
+    uint8_t p,n;
+    bool alive;
+    memset(this->table, 0, sizeof(this->table));
+    for (p=0; p<PARITIES; p++) {
+        mask = Kernel::EVEN;
+        if (p) {
+            mask = Kernel::ODD;
+        }
+        for (i=0; i<512; i++) {
+            n = 0;
+            for (k=i & mask; k; k >>= 1) {
+                n += k & 1;
+            }
+            alive = i & 0x10 ? survival & (1 << n) : birth & (1 << n);
+            if (alive) {
+                this->table[p][i >> 3] |= 1 << (i & 7);
+            }
+        }
+    }
+}
+
+// avec 2 états, une cellule vivante vieillit (jusqu'à 15) ;
+// sinon, une cellule active qui ne survit pas entame son déclin, et une
+// cellule en déclin poursuit le sien quel que soit son voisinage
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::buildTransitions(uint8_t states) {
+    uint8_t g;
+    for (g=0; g<16; g++) {
+        if (states == 2) {
+            this->transition[0][g] = 0;
+            this->transition[1][g] = g < 15 ? g+1 : 15;
+        } else if (g < 2) {
+            this->transition[0][g] = g == 1 ? 2 % states : 0;
+            this->transition[1][g] = 1;
+        } else {
+            this->transition[0][g] = g+1 < states ? g+1 : 0;
+            this->transition[1][g] = this->transition[0][g];
+        }
+    }
+}
+
+// ramène (x,y) dans la grille selon la topologie courante : renvoie 0 si
+// la cellule désignée appartient à une bordure morte, sinon 1, plus 2
+// (resp. 4) si le passage du bord a inversé le sens horizontal (resp.
+// vertical) ; sur une bouteille de Klein, chaque passage par le haut ou
+// le bas retourne la rangée
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+uint8_t Automaton<W,H,Boundary,Kernel>::locate(size_t& x, size_t& y) {
+    uint8_t flags = 1;
+    size_t crossings;
+    if (x < 1 || x > W) {
+        if (this->columns == EDGE_DEAD) {
+            return 0;
+        } else if (this->columns == EDGE_REFLECT) {
+            x = x < 1 ? 1 : x <= 2*W ? 2*W+1 - x : W;
+            flags |= 2;
+        } else {
+            x = (x + W - 1) % W + 1;
+        }
+    }
+    if (y < 1 || y > H) {
+        if (this->rows == EDGE_DEAD) {
+            return 0;
+        } else if (this->rows == EDGE_REFLECT) {
+            y = y < 1 ? 1 : y <= 2*H ? 2*H+1 - y : H;
+            flags |= 4;
+        } else {
+            crossings = y < 1 ? 1 : (y-1) / H;
+            y = (y + H - 1) % H + 1;
+            if (this->rows == EDGE_FLIP && (crossings & 1)) {
+                x = W+1 - x;
+                flags |= 2;
+            }
+        }
+    }
+    return flags;
+}
+
+// les coordonnées de la partie visible vont de (1,1) à (W,H) ; au-delà,
+// c'est la topologie qui décide de la cellule désignée
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+uint8_t* Automaton<W,H,Boundary,Kernel>::cell(size_t x, size_t y) {
+    if (!this->locate(x, y)) {
+        return NULL;
+    }
+    return this->grid + (y-1)*STRIDE + x-1;
+}
+
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+uint8_t Automaton<W,H,Boundary,Kernel>::getCell(size_t x, size_t y) {
+    uint8_t* c = this->cell(x, y);
+    return c ? *c : 0;
+}
+
+// tuiles de la ligne de tuiles ty dont au moins une cellule
+// a changé d'état lors de la dernière génération
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+uint32_t Automaton<W,H,Boundary,Kernel>::getChangedTiles(uint8_t ty) {
+    return this->changed[ty];
+}
+
+// cellules de la tuile tx, sur la rangée y (comptée à partir de 0), qui
+// ont changé d'état lors de la dernière génération
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+uint8_t Automaton<W,H,Boundary,Kernel>::getChangedCells(uint8_t y, uint8_t tx) {
+    return this->dirty[y][tx];
+}
+
+// rectangle [x,xsup[ x [y,ysup[ contenant toutes les cellules non vides
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::getBounds(uint8_t& x, uint8_t& y, uint8_t& xsup, uint8_t& ysup) {
+    x = this->left;
+    y = this->top;
+    xsup = this->right;
+    ysup = this->bottom;
+}
+
+// la grille est entièrement visible : il n'y a pas de fenêtre à déplacer
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+bool Automaton<W,H,Boundary,Kernel>::pan(int8_t dx, int8_t dy) {
+    return false;
+}
+
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::spawn(size_t x, size_t y) {
+    uint8_t* c = this->cell(x, y);
+    if (c) {
+        if (this->sparse && !*c) {
+            if (this->population < SPARSE_MAX) {
+                this->live[this->population++] = c - this->grid;
+            } else {
+                this->densify();
+            }
+        }
+        *c = this->state(13);
+        this->activate(x, y);
+        this->include(x, y);
+    }
+}
+
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::kill(size_t x, size_t y) {
+    uint8_t* c = this->cell(x, y);
+    uint8_t i;
+    if (c) {
+        if (this->sparse && *c) {
+            for (i=0; i<this->population && this->live[i] != c - this->grid; i++);
+            if (i < this->population) {
+                this->live[i] = this->live[--this->population];
+            }
+        }
+        *c = 0;
+        this->activate(x, y);
+    }
+}
+
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::clear() {
+    uint8_t y;
+    // seul le rectangle englobant peut contenir des cellules non vides
+    for (y=this->top; y<this->bottom; y++) {
+        memset(this->grid + y*STRIDE + this->left, 0, this->right - this->left);
+    }
+    this->left = this->right = this->top = this->bottom = 0;
+    this->activateAll();
+    // un univers vide est le plus creux qui soit
+    this->sparse = this->bounded && !this->large;
+    this->population = 0;
+    if (this->sparse) {
+        memset(this->keys, 0, sizeof(this->keys));
+        memset(this->configs, 0, sizeof(this->configs));
+    }
+}
+
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::randomize(Soup& soup) {
+    uint32_t bits[H][(W + 31) / 32];
+    uint8_t* c = this->grid;
+    size_t x,y;
+    soup.fill(bits[0], W, H);
+    for (y=0; y<H; y++) {
+        for (x=0; x<W; x++, c++) {
+            *c = (bits[y][x / 32] >> (x % 32)) & 1 ? this->state(soup.age()) : 0;
+        }
+    }
+    this->left = this->top = 0;
+    this->right = W;
+    this->bottom = H;
+    this->activateAll();
+    this->densify();
+}
+
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::addPattern(const uint8_t* pattern, uint8_t x, uint8_t y) {
+    uint8_t w = pattern[0];
+    uint8_t h = pattern[1];
+    uint8_t c,l,r;
+    uint8_t* p;
+    size_t i,j;
+    for (i=0; i<h; i++) {
+        for (j=0; j<w; j++) {
+            c = pattern[2 + i*w + j];
+            l = (c & 0xF0) >> 4;
+            r = c & 0xF;
+            if (l && (p = this->cell(x+2*j, y+i)))   { *p = this->state(l); this->include(x+2*j, y+i); }
+            if (r && (p = this->cell(x+2*j+1, y+i))) { *p = this->state(r); this->include(x+2*j+1, y+i); }
+        }
+    }
+    this->activateAll();
+    this->densify();
+}
+
+// la cellule (x,y) vient d'être modifiée : sa tuile et les tuiles
+// voisines devront être évaluées à la prochaine génération
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::activate(size_t x, size_t y) {
+    uint32_t changes[3];
+    this->locate(x, y);
+    changes[0] = changes[1] = changes[2] = 1UL << ((x-1) / TILE);
+    this->mark(x-1, y-1);
+    // on considère la cellule sur les quatre bords de sa tuile
+    this->spread(this->active, ((y-1) / TILE) * TILE, changes);
+    this->spread(this->active, ((y-1) / TILE) * TILE + TILE-1, changes);
+}
+
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::activateAll() {
+    uint8_t ty;
+    for (ty=0; ty<TILES_Y; ty++) {
+        this->active[ty]  = (1UL << (TILES_X-1) << 1) - 1;
+        this->changed[ty] = this->active[ty];
+    }
+    memset(this->dirty, 0xFF, sizeof(this->dirty));
+}
+
+// la cellule (x,y), comptée à partir de 0, a changé d'état
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::mark(size_t x, size_t y) {
+    this->changed[y / TILE] |= 1UL << (x / TILE);
+    this->dirty[y][x / TILE] |= 1 << (x % TILE);
+}
+
+// agrandit le rectangle englobant pour y inclure la cellule (x,y)
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::include(size_t x, size_t y) {
+    this->locate(x, y);
+    if (this->left == this->right) {
+        this->left = x-1;
+        this->top = y-1;
+        this->right = x;
+        this->bottom = y;
+    } else {
+        if (x-1 < this->left)   { this->left = x-1; }
+        if (x > this->right)    { this->right = x; }
+        if (y-1 < this->top)    { this->top = y-1; }
+        if (y > this->bottom)   { this->bottom = y; }
+    }
+}
+
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+bool Automaton<W,H,Boundary,Kernel>::isEmpty(size_t x, size_t y, size_t xsup, size_t ysup) {
+    const uint8_t* r;
+    size_t i;
+    for (; y<ysup; y++) {
+        r = this->grid + y*STRIDE;
+        for (i=x; i<xsup; i++) {
+            if (r[i]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// resserre le rectangle englobant tant que ses rangées ou colonnes
+// extrêmes sont vides
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::shrink() {
+    while (this->top < this->bottom && this->isEmpty(this->left, this->top, this->right, this->top+1)) {
+        this->top++;
+    }
+    while (this->top < this->bottom && this->isEmpty(this->left, this->bottom-1, this->right, this->bottom)) {
+        this->bottom--;
+    }
+    if (this->top == this->bottom) {
+        this->left = this->right = this->top = this->bottom = 0;
+        return;
+    }
+    while (this->isEmpty(this->left, this->top, this->left+1, this->bottom)) {
+        this->left++;
+    }
+    while (this->isEmpty(this->right-1, this->top, this->right, this->bottom)) {
+        this->right--;
+    }
+}
+
+// repasse en mode dense : toutes les tuiles sont à évaluer, et la
+// population sera recensée dès la prochaine génération
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::densify() {
+    uint8_t ty;
+    this->sparse = false;
+    this->census = 1;
+    for (ty=0; ty<TILES_Y; ty++) {
+        this->active[ty] = (1UL << (TILES_X-1) << 1) - 1;
+    }
+}
+
+// recense les cellules non vides du rectangle englobant, et passe en
+// mode creux si elles sont au plus SPARSE_IN
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+bool Automaton<W,H,Boundary,Kernel>::sparsify() {
+    const uint8_t* r;
+    uint8_t n = 0;
+    size_t x,y;
+    if (this->large) {
+        return false;
+    }
+    for (y=this->top; y<this->bottom; y++) {
+        r = this->grid + y*STRIDE;
+        for (x=this->left; x<this->right; x++) {
+            if (r[x]) {
+                if (n == SPARSE_IN) {
+                    return false;
+                }
+                this->live[n++] = y*STRIDE + x;
+            }
+        }
+    }
+    this->population = n;
+    this->sparse = true;
+    memset(this->keys, 0, sizeof(this->keys));
+    memset(this->configs, 0, sizeof(this->configs));
+    return true;
+}
+
+// case de la table de hachage associée à la cellule c, créée au besoin
+// et alors ajoutée à la liste filled
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+uint16_t Automaton<W,H,Boundary,Kernel>::slot(uint16_t c) {
+    uint16_t h = (c * 40503U) & (SLOTS-1);
+    while (this->keys[h] && this->keys[h] != c+1) {
+        h = (h + 1) & (SLOTS-1);
+    }
+    if (!this->keys[h]) {
+        this->keys[h] = c+1;
+        this->filled[this->touched++] = h;
+    }
+    return h;
+}
+
+// génération suivante en mode creux : chaque cellule active dépose son
+// bit dans la configuration de ses 9 voisines (elle comprise), puis
+// seules les cellules ainsi touchées, et celles en déclin, sont évaluées
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::stepSparse() {
+    uint16_t c,h,k,i;
+    size_t x,y,nx,ny;
+    int8_t dx,dy,px,py;
+    uint8_t f,g,alive,count = 0;
+    bool overflow = false;
+    bool inner;
+
+    this->touched = 0;
+    for (k=0; k<this->population; k++) {
+        c = this->live[k];
+        if (!((this->firing >> this->grid[c]) & 1)) {
+            this->slot(c);
+            continue;
+        }
+        x = c % STRIDE + 1;
+        y = c / STRIDE + 1;
+        // loin des bords, les voisines sont toutes dans la grille
+        inner = x > 1 && x < W && y > 1 && y < H;
+        for (dy=-1; dy<=1; dy++) {
+            for (dx=-1; dx<=1; dx++) {
+                nx = x + dx;
+                ny = y + dy;
+                f = inner ? 1 : this->locate(nx, ny);
+                if (!f) {
+                    continue;
+                }
+                // la cellule c est en (px,py) = (-dx,-dy) par rapport à sa
+                // voisine, à moins que le bord franchi n'inverse un sens
+                px = f & 2 ? dx : -dx;
+                py = f & 4 ? dy : -dy;
+                h = this->slot((ny-1)*STRIDE + nx-1);
+                this->configs[h] |= 1 << ((1-px)*3 + 1-py);
+            }
+        }
+    }
+
+    memset(this->changed, 0, sizeof(this->changed));
+    memset(this->dirty, 0, sizeof(this->dirty));
+    this->left = this->right = this->top = this->bottom = 0;
+    for (k=0; k<this->touched; k++) {
+        h = this->filled[k];
+        c = this->keys[h] - 1;
+        i = this->configs[h];
+        this->keys[h] = this->configs[h] = 0;
+        alive = (this->table[c / STRIDE % PARITIES][i >> 3] >> (i & 7)) & 1;
+        g = this->transition[alive][this->grid[c]];
+        if (g != this->grid[c]) {
+            this->grid[c] = g;
+            this->mark(c % STRIDE, c / STRIDE);
+        }
+        if (g) {
+            this->include(c % STRIDE + 1, c / STRIDE + 1);
+            if (count < SPARSE_MAX) {
+                this->live[count++] = c;
+            } else {
+                overflow = true;
+            }
+        }
+    }
+
+    this->population = count;
+    if (overflow) {
+        this->densify();
+    }
+}
+
+// active, dans next, les tuiles concernées par les changements de la
+// rangée y : changes[0] indique les tuiles où une cellule a changé,
+// changes[1] (resp. changes[2]) celles dont la première (resp. dernière)
+// colonne a changé, qui touchent donc la tuile de gauche (resp. droite) ;
+// sur la première ou la dernière rangée d'une tuile, les tuiles du
+// dessus ou du dessous sont aussi concernées ; sur une bouteille de Klein,
+// la rangée opposée est retournée, et on l'active alors en entier
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::spread(uint32_t* next, size_t y, const uint32_t* changes) {
+    uint8_t ty = y / TILE;
+    uint32_t all = (1UL << (TILES_X-1) << 1) - 1;
+    uint32_t m = changes[0] | (changes[1] >> 1) | (changes[2] << 1);
+    if (this->columns == EDGE_WRAP) {
+        m |= ((changes[1] & 1) << (TILES_X-1)) | (changes[2] >> (TILES_X-1));
+    }
+    m &= all;
+
+    next[ty] |= m;
+    if (y % TILE == 0) {
+        if (ty > 0) {
+            next[ty-1] |= m;
+        } else if (this->rows == EDGE_WRAP) {
+            next[TILES_Y-1] |= m;
+        } else if (this->rows == EDGE_FLIP) {
+            next[TILES_Y-1] |= all;
+        }
+    }
+    if (y % TILE == TILE-1 || y == H-1) {
+        if (ty < TILES_Y-1) {
+            next[ty+1] |= m;
+        } else if (this->rows == EDGE_WRAP) {
+            next[0] |= m;
+        } else if (this->rows == EDGE_FLIP) {
+            next[0] |= all;
+        }
+    }
+}
+
+// recopie la rangée y (de 0 à H-1), retournée si flip, dans un tampon de
+// W+2 cellules, encadrée selon la topologie T par les cellules opposées
+// ou par celles du bord ; sur une bordure morte, les extrémités du tampon
+// restent nulles
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+template <class T>
+void Automaton<W,H,Boundary,Kernel>::load(size_t y, uint8_t* buffer, bool flip) {
+    const uint8_t* r = this->grid + y*STRIDE;
+    size_t x;
+    if (flip) {
+        for (x=0; x<W; x++) {
+            buffer[W-x] = r[x];
+        }
+    } else {
+        memcpy(buffer+1, r, W);
+    }
+    if (T::COLUMNS == EDGE_WRAP) {
+        buffer[0] = buffer[W];
+        buffer[W+1] = buffer[1];
+    } else if (T::COLUMNS == EDGE_REFLECT) {
+        buffer[0] = buffer[1];
+        buffer[W+1] = buffer[W];
+    }
+}
+
+// code sur 3 bits de la colonne (haut, centre, bas) de la fenêtre,
+// où seules les cellules dans un état actif sont comptées
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+uint8_t Automaton<W,H,Boundary,Kernel>::column(const uint8_t* a, const uint8_t* c, const uint8_t* b) {
+    uint16_t f = this->firing;
+    return (((f >> *a) & 1) << 2) | (((f >> *c) & 1) << 1) | ((f >> *b) & 1);
+}
+
+// nombre de cellules vivantes dans une colonne de la fenêtre
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+uint8_t Automaton<W,H,Boundary,Kernel>::count(const uint8_t* a, const uint8_t* c, const uint8_t* b) {
+    return (*a != 0) + (*c != 0) + (*b != 0);
+}
+
+// calcule les cellules x à xsup-1 de la rangée r de la nouvelle génération
+// à partir des rangées a (au-dessus), c (courante) et b (au-dessous) de la
+// génération précédente ; les tuiles de la plage qui ont changé sont
+// ajoutées aux masques changes (voir spread()), et ses cellules qui ont
+// changé à cells, la rangée de dirty ; la plage peut commencer ou finir au
+// milieu d'une tuile, au bord du rectangle englobant : les colonnes
+// extrêmes de la tuile n'ont alors pas changé
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::applyRules(const uint8_t* a, const uint8_t* c, const uint8_t* b, uint8_t* r, size_t x, size_t xsup, uint32_t* changes, uint8_t* cells) {
+    uint8_t alive,g,d;
+    uint32_t t;
+    size_t tsup;
+    // index glissant de la configuration 3x3 : à chaque cellule, on décale
+    // les colonnes d'un cran vers la gauche et on insère celle de droite
+    uint16_t i;
+
+    a += x; c += x; b += x; r += x;
+    i = (this->column(a, c, b) << 3) | this->column(a+1, c+1, b+1);
+
+    for (a+=2, c+=2, b+=2; x<xsup; ) {
+        tsup = (x / TILE + 1) * TILE;
+        tsup = tsup < xsup ? tsup : xsup;
+        t = 1UL << (x / TILE);
+        d = 0;
+        for (; x<tsup; x++, a++, c++, b++, r++) {
+            i = ((i << 3) | this->column(a, c, b)) & 0x1FF;
+            alive = (this->table[0][i >> 3] >> (i & 7)) & 1;
+            g = this->transition[alive][c[-1]];
+            d |= (g != c[-1]) << (x % TILE);
+            *r = g;
+        }
+        if (d) {
+            cells[(x-1) / TILE] |= d;
+            changes[0] |= t;
+            if (d & 1) { changes[1] |= t; }
+            if ((x % TILE == 0 || x == W) && ((d >> ((x-1) % TILE)) & 1)) { changes[2] |= t; }
+        }
+    }
+}
+
+// noyau dédié à B3/S23 : avec s la somme glissante des 9 cellules
+// du voisinage, une cellule est vivante si s vaut 3, ou si s vaut 4
+// et qu'elle l'était déjà
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::applyConway(const uint8_t* a, const uint8_t* c, const uint8_t* b, uint8_t* r, size_t x, size_t xsup, uint32_t* changes, uint8_t* cells) {
+    uint8_t g,n,alive,d;
+    uint8_t sl,sm,sr,s;
+    uint32_t t;
+    size_t tsup;
+
+    a += x; c += x; b += x; r += x;
+    sl = this->count(a, c, b);
+    sm = this->count(a+1, c+1, b+1);
+    s = sl + sm;
+
+    for (a+=2, c+=2, b+=2; x<xsup; ) {
+        tsup = (x / TILE + 1) * TILE;
+        tsup = tsup < xsup ? tsup : xsup;
+        t = 1UL << (x / TILE);
+        d = 0;
+        for (; x<tsup; x++, a++, c++, b++, r++) {
+            sr = this->count(a, c, b);
+            s += sr;
+            g = c[-1];
+            alive = (s == 3) | ((s == 4) & (g != 0));
+            n = (g + (g < 15)) & -alive;
+            d |= (n != g) << (x % TILE);
+            *r = n;
+            s -= sl;
+            sl = sm;
+            sm = sr;
+        }
+        if (d) {
+            cells[(x-1) / TILE] |= d;
+            changes[0] |= t;
+            if (d & 1) { changes[1] |= t; }
+            if ((x % TILE == 0 || x == W) && ((d >> ((x-1) % TILE)) & 1)) { changes[2] |= t; }
+        }
+    }
+}
+
+// noyau des voisinages de von Neumann et hexagonal : Kernel compte les
+// voisins actifs, dont le nombre indexe directement les masques de la
+// règle ; side est la colonne des voisines diagonales (voir Hexagonal)
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::applyCounts(const uint8_t* a, const uint8_t* c, const uint8_t* b, uint8_t* r, size_t x, size_t xsup, uint32_t* changes, uint8_t* cells, int8_t side) {
+    uint16_t f = this->firing;
+    uint8_t g,n,alive,d;
+    uint32_t t;
+    size_t tsup;
+
+    a += x+1; c += x+1; b += x+1; r += x;
+
+    while (x < xsup) {
+        tsup = (x / TILE + 1) * TILE;
+        tsup = tsup < xsup ? tsup : xsup;
+        t = 1UL << (x / TILE);
+        d = 0;
+        for (; x<tsup; x++, a++, c++, b++, r++) {
+            g = *c;
+            n = Kernel::count(a, c, b, side, f);
+            alive = (this->conditions[(f >> g) & 1] >> n) & 1;
+            n = this->transition[alive][g];
+            d |= (n != g) << (x % TILE);
+            *r = n;
+        }
+        if (d) {
+            cells[(x-1) / TILE] |= d;
+            changes[0] |= t;
+            if (d & 1) { changes[1] |= t; }
+            if ((x % TILE == 0 || x == W) && ((d >> ((x-1) % TILE)) & 1)) { changes[2] |= t; }
+        }
+    }
+}
+
+// achève la génération en cours (voir stepRows()), ou en calcule une entière
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::step() {
+    this->stepRows(H);
+}
+
+// calcule au plus rows rangées de la génération, en la commençant si aucune
+// n'est en cours, et renvoie true une fois qu'elle est achevée ; seules les
+// règles sur le voisinage 3x3 en mode dense se découpent ainsi, les autres
+// générations sont calculées d'un bloc ; tant qu'une génération est en
+// cours, la grille mêle deux générations : aucune autre méthode ne doit
+// alors être appelée ; la topologie n'est consultée qu'une fois par
+// tranche : chacune a son propre exemplaire d'advance(), où les tests sur
+// le bord sont résolus à la compilation
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+bool Automaton<W,H,Boundary,Kernel>::stepRows(uint8_t rows) {
+    if (this->sparse) {
+        this->stepSparse();
+        return true;
+    }
+    switch (this->topology) {
+        case Torus::ID:       return this->template advance<Torus>(rows);
+        case KleinBottle::ID: return this->template advance<KleinBottle>(rows);
+        case Cylinder::ID:    return this->template advance<Cylinder>(rows);
+        case DeadBorder::ID:  return this->template advance<DeadBorder>(rows);
+        case Mirror::ID:      return this->template advance<Mirror>(rows);
+    }
+    return true;
+}
+
+// une génération est-elle en cours (stepRows() ne l'a pas achevée) ?
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+bool Automaton<W,H,Boundary,Kernel>::isPending() {
+    return this->pending;
+}
+
+// avance de n générations d'un coup : les générations intermédiaires ne
+// sont jamais affichées, et getChangedTiles() signale ensuite toutes les
+// tuiles modifiées par l'une d'elles, de quoi redessiner l'état final ;
+// toutes leurs cellules sont alors considérées comme changées
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::step(uint16_t n) {
+    uint32_t seen[TILES_Y];
+    uint8_t ty,tx,y;
+    memset(seen, 0, sizeof(seen));
+    while (n--) {
+        this->step();
+        for (ty=0; ty<TILES_Y; ty++) {
+            seen[ty] |= this->changed[ty];
+        }
+    }
+    memcpy(this->changed, seen, sizeof(seen));
+    for (y=0; y<H; y++) {
+        for (tx=0; tx<TILES_X; tx++) {
+            this->dirty[y][tx] = (seen[y / TILE] >> tx) & 1 ? 0xFF : 0;
+        }
+    }
+}
+
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+template <class T>
+bool Automaton<W,H,Boundary,Kernel>::advance(uint8_t rows) {
+    size_t xlo,xhi,ylo,yhi;
+
+    if (!this->pending) {
+        memset(this->changed, 0, sizeof(this->changed));
+        memset(this->dirty, 0, sizeof(this->dirty));
+        if (!this->template widen<T>(this->large ? this->radius : 1, xlo, xhi, ylo, yhi)) {
+            memset(this->active, 0, sizeof(this->active));
+            this->sparsify();
+            return true;
+        }
+        if (this->large) {
+            if (this->diamond) {
+                this->template advanceDiamond<T>(xlo, xhi, ylo, yhi);
+            } else {
+                this->template advanceSquare<T>(xlo, xhi, ylo, yhi);
+            }
+            this->conclude(xlo, xhi, ylo, yhi);
+            return true;
+        }
+        this->template prepareTiles<T>(xlo, xhi, ylo, yhi);
+    }
+
+    if (!this->template advanceTiles<T>(rows)) {
+        return false;
+    }
+    this->conclude(this->x0, this->x1, this->y0, this->y1);
+    return true;
+}
+
+// fin d'une génération calculée sur la plage [xlo,xhi[ x [ylo,yhi[
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+void Automaton<W,H,Boundary,Kernel>::conclude(size_t xlo, size_t xhi, size_t ylo, size_t yhi) {
+    this->left = xlo;
+    this->right = xhi;
+    this->top = ylo;
+    this->bottom = yhi;
+    this->shrink();
+
+    if (this->bounded && --this->census == 0) {
+        this->census = CENSUS;
+        this->sparsify();
+    }
+}
+
+// rectangle englobant agrandi de d cellules, la portée du voisinage : hors
+// de celui-ci, aucune cellule ne peut naître ; si le bord est replié, un
+// rectangle qui en est à moins de d cellules s'étend à toute la largeur
+// (ou la hauteur), et sur une bouteille de Klein, le retournement impose
+// en plus toute la largeur ; renvoie false si l'univers est vide
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+template <class T>
+bool Automaton<W,H,Boundary,Kernel>::widen(uint8_t d, size_t& xlo, size_t& xhi, size_t& ylo, size_t& yhi) {
+    if (!this->bounded) {
+        this->left = this->top = 0;
+        this->right = W;
+        this->bottom = H;
+    }
+    if (this->left == this->right) {
+        return false;
+    }
+    xlo = this->left > d ? this->left-d : 0;
+    xhi = this->right + d < W ? this->right+d : W;
+    ylo = this->top > d ? this->top-d : 0;
+    yhi = this->bottom + d < H ? this->bottom+d : H;
+    if (T::COLUMNS == EDGE_WRAP && (this->left < d || this->right + d > W)) {
+        xlo = 0;
+        xhi = W;
+    }
+    if ((T::ROWS == EDGE_WRAP || T::ROWS == EDGE_FLIP) && (this->top < d || this->bottom + d > H)) {
+        ylo = 0;
+        yhi = H;
+        if (T::ROWS == EDGE_FLIP) {
+            xlo = 0;
+            xhi = W;
+        }
+    }
+    return true;
+}
+
+// commence une génération sur le voisinage 3x3, sur la plage
+// [xlo,xhi[ x [ylo,yhi[ : la fenêtre reçoit les rangées ylo-1 et ylo
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+template <class T>
+void Automaton<W,H,Boundary,Kernel>::prepareTiles(size_t xlo, size_t xhi, size_t ylo, size_t yhi) {
+    this->x0 = xlo;
+    this->x1 = xhi;
+    this->y0 = ylo;
+    this->y1 = yhi;
+    this->line = ylo;
+    this->above = this->window[0];
+    this->current = this->window[1];
+    this->below = this->window[2];
+    this->pending = true;
+    memset(this->next, 0, sizeof(this->next));
+
+    if (T::COLUMNS == EDGE_DEAD || T::ROWS == EDGE_DEAD) {
+        memset(this->window, 0, sizeof(this->window));
+        memset(this->first, 0, sizeof(this->first));
+    }
+    if (ylo > 0) {
+        this->template load<T>(ylo-1, this->above, false);
+    } else if (T::ROWS == EDGE_WRAP || T::ROWS == EDGE_FLIP) {
+        this->template load<T>(H-1, this->above, T::ROWS == EDGE_FLIP);
+    } else if (T::ROWS == EDGE_REFLECT) {
+        this->template load<T>(0, this->above, false);
+    }
+    this->template load<T>(ylo, this->current, false);
+    if (yhi == H && (T::ROWS == EDGE_WRAP || T::ROWS == EDGE_FLIP)) {
+        this->template load<T>(0, this->first, T::ROWS == EDGE_FLIP);
+    } else if (yhi == H && T::ROWS == EDGE_REFLECT) {
+        this->template load<T>(H-1, this->first, false);
+    }
+}
+
+// poursuit la génération en cours, tuile par tuile, sur au plus rows
+// rangées ; renvoie true si elle est achevée
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+template <class T>
+bool Automaton<W,H,Boundary,Kernel>::advanceTiles(uint8_t rows) {
+    uint8_t* a = this->above;
+    uint8_t* c = this->current;
+    uint8_t* b = this->below;
+    uint8_t* t;
+    uint8_t* r;
+    uint32_t changes[3];
+    uint32_t m;
+    uint8_t tx,txsup;
+    size_t y,x,xsup;
+
+    for (y=this->line; y<this->y1 && rows; y++, rows--) {
+        if (y == H-1) {
+            b = this->first;
+        } else {
+            this->template load<T>(y+1, b, false);
+        }
+        // on n'évalue que les plages de tuiles actives consécutives,
+        // limitées au rectangle englobant
+        m = this->active[y / TILE];
+        r = this->grid + y*STRIDE;
+        changes[0] = changes[1] = changes[2] = 0;
+        for (tx=this->x0 / TILE; tx<TILES_X && (m >> tx); tx=txsup) {
+            for (; !((m >> tx) & 1); tx++);
+            for (txsup=tx; txsup<TILES_X && ((m >> txsup) & 1); txsup++);
+            x = tx*TILE > this->x0 ? tx*TILE : this->x0;
+            xsup = txsup*TILE < this->x1 ? txsup*TILE : this->x1;
+            if (x >= xsup) {
+                break;
+            }
+            if (Kernel::ID != Moore::ID) {
+                this->applyCounts(a, c, b, r, x, xsup, changes, this->dirty[y], y & 1 ? 1 : -1);
+            } else if (this->conway) {
+                this->applyConway(a, c, b, r, x, xsup, changes, this->dirty[y]);
+            } else {
+                this->applyRules(a, c, b, r, x, xsup, changes, this->dirty[y]);
+            }
+        }
+        if (changes[0]) {
+            this->changed[y / TILE] |= changes[0];
+            this->spread(this->next, y, changes);
+        }
+        t = a; a = c; c = b; b = t;
+    }
+    this->above = a;
+    this->current = c;
+    this->below = b;
+    this->line = y;
+    if (y < this->y1) {
+        return false;
+    }
+
+    memcpy(this->active, this->next, sizeof(this->next));
+    this->pending = false;
+    return true;
+}
+
+// recopie dans un tampon de SPAN cellules l'activité (0 ou 1) des cellules
+// de la rangée y, qui va de -radius à H+radius-1 : la rangée est encadrée
+// de radius cellules de chaque côté, prises selon la topologie T, à partir
+// de l'indice MARGIN du tampon
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+template <class T>
+void Automaton<W,H,Boundary,Kernel>::loadWide(int16_t y, uint8_t* buffer) {
+    uint8_t* v = buffer + MARGIN;
+    const uint8_t* r;
+    uint16_t f = this->firing;
+    bool flip = false;
+    int16_t x;
+    memset(buffer, 0, SPAN);
+    if (y < 0 || y >= H) {
+        if (T::ROWS == EDGE_DEAD) {
+            return;
+        } else if (T::ROWS == EDGE_REFLECT) {
+            y = y < 0 ? -1-y : 2*H-1 - y;
+        } else {
+            flip = T::ROWS == EDGE_FLIP;
+            y = (y + H) % H;
+        }
+    }
+    r = this->grid + y*STRIDE;
+    for (x=0; x<W; x++) {
+        v[flip ? W-1 - x : x] = (f >> r[x]) & 1;
+    }
+    for (x=1; x<=this->radius; x++) {
+        if (T::COLUMNS == EDGE_WRAP) {
+            v[-x] = v[W-x];
+            v[W-1+x] = v[x-1];
+        } else if (T::COLUMNS == EDGE_REFLECT) {
+            v[-x] = v[x-1];
+            v[W-1+x] = v[W-x];
+        }
+    }
+}
+
+// nouvel état d'une cellule d'état g qui a n voisins actifs, elle exclue
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+uint8_t Automaton<W,H,Boundary,Kernel>::evolve(uint8_t g, uint8_t n) {
+    bool alive = (this->firing >> g) & 1
+        ? n >= this->survivalMin && n <= this->survivalMax
+        : n >= this->birthMin && n <= this->birthMax;
+    return this->transition[alive][g];
+}
+
+// Larger than Life, voisinage de Moore : sums[i] est la somme de la colonne
+// i sur les 2R+1 rangées centrées sur la rangée courante, mise à jour d'une
+// rangée à l'autre en ajoutant celle qui entre et en retirant celle qui
+// sort ; une somme glissante sur 2R+1 colonnes donne alors le nombre de
+// voisins en O(1) par cellule, quel que soit R
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+template <class T>
+void Automaton<W,H,Boundary,Kernel>::advanceSquare(size_t xlo, size_t xhi, size_t ylo, size_t yhi) {
+    // rangées de la génération précédente, et celles qui prolongent la
+    // dernière (tail), lues avant que la génération ne les écrase
+    uint8_t (*rows)[SPAN] = this->ring[0];
+    uint8_t* sums = this->strip;
+    const uint8_t R = this->radius;
+    const uint8_t* v;
+    uint8_t* r;
+    uint8_t s,g,n;
+    int16_t y,k;
+    size_t x,i;
+
+    for (k=H; k<(int16_t)yhi+R; k++) {
+        this->template loadWide<T>(k, this->tail[k-H]);
+    }
+    memset(sums, 0, SPAN);
+    for (k=(int16_t)ylo-R; k<(int16_t)yhi+R; k++) {
+        v = rows[(k + RING) % RING];
+        if (k >= H) {
+            memcpy(rows[(k + RING) % RING], this->tail[k-H], SPAN);
+        } else {
+            this->template loadWide<T>(k, rows[(k + RING) % RING]);
+        }
+        for (i=0; i<SPAN; i++) {
+            sums[i] += v[i];
+        }
+        y = k - R;
+        if (y < (int16_t)ylo) {
+            continue;
+        }
+
+        r = this->grid + y*STRIDE;
+        for (s=0, i=xlo; i<=xlo+2*R; i++) {
+            s += sums[i + MARGIN - R];
+        }
+        for (x=xlo; x<xhi; x++) {
+            if (x > xlo) {
+                s += sums[x + MARGIN + R] - sums[x + MARGIN - R - 1];
+            }
+            g = r[x];
+            n = this->evolve(g, s - ((this->firing >> g) & 1));
+            if (n != g) {
+                r[x] = n;
+                this->mark(x, y);
+            }
+        }
+
+        v = rows[(y - R + RING) % RING];
+        for (i=0; i<SPAN; i++) {
+            sums[i] -= v[i];
+        }
+    }
+}
+
+// Larger than Life, voisinage de von Neumann (losange |dx|+|dy| <= R) :
+// d'une cellule à sa voisine de droite, le losange gagne un bord droit en
+// chevron et perd un bord gauche, chacun fait de deux segments diagonaux ;
+// les sommes cumulées le long des diagonales (diag, vers le bas à droite)
+// et des antidiagonales (anti, vers le bas à gauche) donnent chaque
+// segment en O(1), le losange n'étant compté entièrement qu'en début de
+// rangée ; les sommes sont prises modulo 256, seules leurs différences,
+// toujours inférieures, comptent
+template <uint8_t W, uint8_t H, class Boundary, class Kernel>
+template <class T>
+void Automaton<W,H,Boundary,Kernel>::advanceDiamond(size_t xlo, size_t xhi, size_t ylo, size_t yhi) {
+    uint8_t (*diag)[SPAN] = this->ring[0];
+    uint8_t (*anti)[SPAN] = this->ring[1];
+    uint8_t* line = this->strip;
+    const uint8_t R = this->radius;
+    const uint8_t* pd;
+    const uint8_t* pa;
+    const uint8_t* bd;
+    const uint8_t* ba;
+    uint8_t* d;
+    uint8_t* a;
+    uint8_t* r;
+    uint8_t s,g,n;
+    int16_t y,k,dy,dx,span;
+    size_t x,i;
+
+    for (k=H; k<(int16_t)yhi+R; k++) {
+        this->template loadWide<T>(k, this->tail[k-H]);
+    }
+    // les sommes de la première rangée lue partent de zéro
+    k = (int16_t)ylo - R - 1;
+    memset(diag[(k - 1 + RING) % RING], 0, SPAN);
+    memset(anti[(k - 1 + RING) % RING], 0, SPAN);
+    for (; k<(int16_t)yhi+R; k++) {
+        if (k >= H) {
+            memcpy(line, this->tail[k-H], SPAN);
+        } else {
+            this->template loadWide<T>(k, line);
+        }
+        d = diag[(k + RING) % RING];
+        a = anti[(k + RING) % RING];
+        pd = diag[(k - 1 + RING) % RING];
+        pa = anti[(k - 1 + RING) % RING];
+        d[0] = line[0];
+        for (i=1; i<SPAN; i++) {
+            d[i] = line[i] + pd[i-1];
+        }
+        a[SPAN-1] = line[SPAN-1];
+        for (i=0; i<SPAN-1; i++) {
+            a[i] = line[i] + pa[i+1];
+        }
+        y = k - R;
+        if (y < (int16_t)ylo) {
+            continue;
+        }
+
+        // losange complet autour de la première cellule, dont chaque
+        // cellule se déduit de deux sommes diagonales consécutives
+        i = xlo + MARGIN;
+        s = 0;
+        for (dy=-R; dy<=R; dy++) {
+            span = R - (dy < 0 ? -dy : dy);
+            d = diag[(y + dy + RING) % RING];
+            pd = diag[(y + dy - 1 + RING) % RING];
+            for (dx=-span; dx<=span; dx++) {
+                s += d[i+dx] - pd[i+dx-1];
+            }
+        }
+
+        r = this->grid + y*STRIDE;
+        pd = diag[(y - R - 1 + RING) % RING];
+        pa = anti[(y - R - 1 + RING) % RING];
+        d = diag[(y + RING) % RING];
+        a = anti[(y + RING) % RING];
+        bd = diag[(y + R + RING) % RING];
+        ba = anti[(y + R + RING) % RING];
+        for (x=xlo; x<xhi; x++, i++) {
+            if (x > xlo) {
+                s += (uint8_t)(d[i+R] - pd[i-1]) + (uint8_t)(ba[i] - a[i+R]);
+                s -= (uint8_t)(a[i-1-R] - pa[i]) + (uint8_t)(bd[i-1] - d[i-1-R]);
+            }
+            g = r[x];
+            n = this->evolve(g, s - ((this->firing >> g) & 1));
+            if (n != g) {
+                r[x] = n;
+                this->mark(x, y);
+            }
+        }
+    }
+}
+
+#endif
@@ -1,43 +1,123 @@
 #include "AutomatonController.h"
 
-AutomatonController::AutomatonController(Automaton* model, AutomatonView* view) : model(model), view(view) {
+AutomatonController::AutomatonController(Universe* model, UniverseView* view) : model(model), view(view), seed(0), density(Soup::DENSITY), symmetry(Soup::NONE) {
 
 }
 
+UniverseView* AutomatonController::getView() {
+    return this->view;
+}
+
 void AutomatonController::begin() {
-    this->randomize();
+    this->randomize(Soup::DENSITY, Soup::NONE);
     this->view->draw();
 }
 
+// pendant l'édition, l'univers n'est pas redessiné : seule la cellule
+// modifiée est repeinte
 void AutomatonController::spawn(size_t x, size_t y) {
     this->model->spawn(x, y);
+    this->view->drawCell(x-1, y-1);
 }
 
 void AutomatonController::kill(size_t x, size_t y) {
     this->model->kill(x, y);
+    this->view->drawCell(x-1, y-1);
 }
 
 void AutomatonController::clear() {
     this->model->clear();
 }
 
-void AutomatonController::randomize() {
-    this->model->randomize();
+// une graine fixe donne la même soupe sur la console et sur un PC
+void AutomatonController::randomize(uint8_t density, uint8_t symmetry) {
+    this->seed = random(0x7FFFFFFF);
+    this->density = density;
+    this->symmetry = symmetry;
+    this->sow();
+}
+
+void AutomatonController::replay() {
+    this->sow();
+}
+
+uint32_t AutomatonController::getSeed() {
+    return this->seed;
+}
+
+void AutomatonController::sow() {
+    Soup soup(this->seed, this->density, this->symmetry);
+    this->model->randomize(soup);
 }
 
 void AutomatonController::addPattern(const uint8_t* pattern, uint8_t x, uint8_t y) {
     this->model->addPattern(pattern, x, y);
 }
 
-void AutomatonController::loop() {
-    this->step();
+bool AutomatonController::setRule(const char* rulestring) {
+    return this->model->setRule(rulestring);
+}
+
+bool AutomatonController::setTopology(uint8_t id) {
+    return this->model->setTopology(id);
+}
+
+void AutomatonController::pan(int8_t dx, int8_t dy) {
+    if (this->model->pan(dx, dy)) {
+        this->view->draw();
+    }
+}
+
+// plusieurs générations par image : seule la dernière est dessinée
+void AutomatonController::loop(uint16_t generations) {
+    if (generations == 1) {
+        this->step();
+    } else if (generations) {
+        this->fastForward(generations);
+    }
 }
 
 void AutomatonController::step() {
     this->model->step();
-    this->view->draw();
+    this->view->drawChanges();
+}
+
+// seul l'état final est dessiné, d'après les tuiles modifiées en route
+void AutomatonController::fastForward(uint16_t generations) {
+    this->model->step(generations);
+    this->view->drawChanges();
+}
+
+// poursuit sur rows rangées la génération étalée sur plusieurs images,
+// qui n'est dessinée qu'une fois achevée
+bool AutomatonController::advance(uint8_t rows) {
+    if (!this->model->stepRows(rows)) {
+        return false;
+    }
+    this->view->drawChanges();
+    return true;
 }
 
+// seul le moteur sait si une génération est en cours
+bool AutomatonController::isPending() {
+    return this->model->isPending();
+}
+
+// achève la génération étalée : la grille mêle deux générations tant
+// qu'elle est en cours, et elle doit l'être avant tout autre accès
+void AutomatonController::settle() {
+    if (this->model->isPending()) {
+        this->model->step();
+        this->view->drawChanges();
+    }
+}
+
+// une génération en cours est d'abord achevée : la grille en mêlerait deux
 void AutomatonController::update() {
+    this->settle();
     this->view->draw();
+}
+
+void AutomatonController::print(const char* text) {
+    this->view->print(text);
 }
\ No newline at end of file
@@ -1,28 +1,44 @@
 #ifndef GAME_OF_LIFE_AUTOMATON_CONTROLLER_H_
 #define GAME_OF_LIFE_AUTOMATON_CONTROLLER_H_
 
-#include "Automaton.h"
-#include "AutomatonView.h"
+#include "Universe.h"
 
 class AutomatonController
 {
     private:
 
-        Automaton* model;
-        AutomatonView* view;
+        Universe* model;
+        UniverseView* view;
+        // la dernière soupe, que l'on peut semer à nouveau
+        uint32_t seed;
+        uint8_t density;
+        uint8_t symmetry;
+
+        void sow();
 
     public:
 
-        AutomatonController(Automaton* model, AutomatonView* view);
+        AutomatonController(Universe* model, UniverseView* view);
+        UniverseView* getView();
         void begin();
         void spawn(size_t x, size_t y);
         void kill(size_t x, size_t y);
         void clear();
-        void randomize();
+        void randomize(uint8_t density, uint8_t symmetry);
+        void replay();
+        uint32_t getSeed();
         void addPattern(const uint8_t* pattern, uint8_t x, uint8_t y);
-        void loop();
+        bool setRule(const char* rulestring);
+        bool setTopology(uint8_t id);
+        void pan(int8_t dx, int8_t dy);
+        void loop(uint16_t generations);
         void step();
+        void fastForward(uint16_t generations);
+        bool advance(uint8_t rows);
+        bool isPending();
+        void settle();
         void update();
+        void print(const char* text);
 };
 
 #endif
\ No newline at end of file
@@ -2,20 +2,206 @@
 #define GAME_OF_LIFE_AUTOMATON_VIEW_H_
 
 #include "bootstrap.h"
-#include "Automaton.h"
 
+template <class Model>
 class AutomatonView
 {
     private:
 
-        static const Color PALETTE[];
+        static Color PALETTE[];
+        static const uint8_t STRIDE = SCREEN_WIDTH / 2;
+        static const uint8_t W = Model::WIDTH;
+        static const uint8_t H = Model::HEIGHT;
+        static const uint8_t TILE = Model::TILE;
+        static const uint8_t SCALE = CellSize<W,H>::PIXELS;
+        static const bool HEX = Model::Neighbourhood::HEX;
+        // bandeau des messages, au bas de l'écran
+        static const uint8_t BANNER = 7;
         
-        Automaton* model;
+        Model* model;
+
+        static uint8_t* pixels();
+        static uint8_t shift(uint8_t y);
+        static void plot(uint16_t u, uint16_t v, uint8_t g);
+        void drawRow(uint8_t y);
 
     public:
 
-        AutomatonView(Automaton* model);
+        AutomatonView(Model* model);
+        static void claim();
         void draw();
+        void drawChanges();
+        void drawCell(uint8_t x, uint8_t y);
+        void restore(int16_t u, int16_t v);
+        void print(const char* text);
 };
 
-#endif
\ No newline at end of file
+// palette matérielle de gb.display : l'indice d'un pixel est directement
+// l'état de la cellule (elle contient les 16 couleurs par défaut, les
+// couleurs nommées restent donc toutes disponibles pour les autres vues)
+template <class Model>
+Color AutomatonView<Model>::PALETTE[] = {BLACK, GREEN, LIGHTGREEN, WHITE, YELLOW, BEIGE, BROWN, ORANGE, RED, PINK, PURPLE, DARKBLUE, BLUE, LIGHTBLUE, GRAY, DARKGRAY};
+
+template <class Model>
+AutomatonView<Model>::AutomatonView(Model* model) : model(model) {
+
+}
+
+// l'image de gb.display sert de tampon d'affichage : elle est conservée ;
+// les pixels y sont écrits par paires dans chaque octet, ce qui suppose le
+// mode indexé choisi dans config-gamebuino.h
+template <class Model>
+void AutomatonView<Model>::claim() {
+    gb.display.setPalette(PALETTE);
+}
+
+// le tampon de gb.display est déclaré en mots de 16 bits (ceux du mode
+// RGB565) : en mode indexé, il est adressé octet par octet, STRIDE octets
+// par rangée de pixels
+template <class Model>
+uint8_t* AutomatonView<Model>::pixels() {
+    return (uint8_t*)gb.display._buffer;
+}
+
+// repeint tout l'écran en un seul passage sur le tampon de gb.display
+template <class Model>
+void AutomatonView<Model>::draw() {
+    uint8_t x,y,xsup,ysup,i;
+    uint8_t* p = pixels();
+    // hors du rectangle englobant, les rangées sont simplement effacées
+    this->model->getBounds(x, y, xsup, ysup);
+    for (i=0; i<H && i*SCALE<SCREEN_HEIGHT; i++) {
+        if (i < y || i >= ysup) {
+            memset(p + i*SCALE*STRIDE, 0, SCALE*STRIDE);
+        } else {
+            this->drawRow(i);
+        }
+    }
+    if (i*SCALE < SCREEN_HEIGHT) {
+        memset(p + i*SCALE*STRIDE, 0, (SCREEN_HEIGHT - i*SCALE) * STRIDE);
+    }
+}
+
+// ne repeint que les cellules modifiées par la dernière génération :
+// l'écran doit donc déjà afficher la génération précédente, que le tampon
+// indexé de gb.display conserve d'une image à l'autre
+template <class Model>
+void AutomatonView<Model>::drawChanges() {
+    uint8_t tx,ty,x,y,i,d;
+    uint32_t m;
+    for (ty=0, y=0; y<H; ty++, y+=TILE) {
+        m = this->model->getChangedTiles(ty);
+        for (tx=0; m; tx++, m >>= 1) {
+            if (!(m & 1)) {
+                continue;
+            }
+            for (i=y; i<y+TILE && i<H; i++) {
+                d = this->model->getChangedCells(i, tx);
+                for (x=tx*TILE; d && x<W; x++, d >>= 1) {
+                    if (d & 1) {
+                        this->drawCell(x, i);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// décalage horizontal de la rangée y : sur une grille hexagonale, les
+// rangées impaires sont décalées d'une demi-cellule (rien à l'échelle 1,
+// et la dernière demi-cellule sort de l'écran si la grille l'occupe)
+template <class Model>
+uint8_t AutomatonView<Model>::shift(uint8_t y) {
+    return HEX && (y & 1) ? SCALE / 2 : 0;
+}
+
+// écrit la rangée de cellules y dans le tampon, deux pixels par octet
+// (le pixel pair dans le quartet de poids fort), puis la recopie sur les
+// SCALE rangées de pixels qu'elle occupe
+template <class Model>
+void AutomatonView<Model>::drawRow(uint8_t y) {
+    uint8_t* row = pixels() + y*SCALE*STRIDE;
+    uint8_t* p = row;
+    uint8_t i,j,k,g,b;
+    if (SCALE == 1) {
+        for (j=0; j<STRIDE; j++) {
+            i = 2*j;
+            b = i < W ? (this->model->getCell(i+1, y+1) & 0xF) << 4 : 0;
+            *p++ = i+1 < W ? b | (this->model->getCell(i+2, y+1) & 0xF) : b;
+        }
+        return;
+    }
+    // k : pixels restant à écrire de la cellule courante, ou du décalage
+    // de la rangée avant la première cellule
+    k = shift(y);
+    g = 0;
+    b = 0;
+    for (i=0, j=0; i<SCREEN_WIDTH; i++) {
+        if (!k) {
+            g = j < W ? this->model->getCell(++j, y+1) & 0xF : 0;
+            k = SCALE;
+        }
+        k--;
+        if (i & 1) {
+            *p++ = b | g;
+        } else {
+            b = g << 4;
+        }
+    }
+    for (i=1; i<SCALE && y*SCALE+i<SCREEN_HEIGHT; i++) {
+        memcpy(row + i*STRIDE, row, STRIDE);
+    }
+}
+
+// écrit l'indice g dans le quartet du pixel (u,v), sans toucher à son
+// voisin d'octet
+template <class Model>
+void AutomatonView<Model>::plot(uint16_t u, uint16_t v, uint8_t g) {
+    uint8_t* p = pixels() + v*STRIDE + u/2;
+    *p = u & 1 ? (*p & 0xF0) | g : (*p & 0x0F) | (g << 4);
+}
+
+// peint la cellule (x,y), à partir de 0, pixel par pixel dans le tampon
+template <class Model>
+void AutomatonView<Model>::drawCell(uint8_t x, uint8_t y) {
+    uint8_t g = this->model->getCell(x+1, y+1) & 0xF;
+    uint16_t u = x*SCALE + shift(y);
+    uint16_t v = y*SCALE;
+    uint16_t i,j;
+    for (i=v; i<v+SCALE && i<SCREEN_HEIGHT; i++) {
+        for (j=u; j<u+SCALE && j<SCREEN_WIDTH; j++) {
+            plot(j, i, g);
+        }
+    }
+}
+
+// rétablit le pixel (u,v), recouvert par un autre dessin (le curseur
+// d'édition), d'après la cellule qu'il représente
+template <class Model>
+void AutomatonView<Model>::restore(int16_t u, int16_t v) {
+    uint8_t g = 0;
+    uint8_t y;
+    int16_t x;
+    if (u < 0 || u >= SCREEN_WIDTH || v < 0 || v >= SCREEN_HEIGHT) {
+        return;
+    }
+    y = v / SCALE;
+    x = u - shift(y);
+    if (y < H && x >= 0 && x / SCALE < W) {
+        g = this->model->getCell(x / SCALE + 1, y + 1) & 0xF;
+    }
+    plot(u, v, g);
+}
+
+// écrit le message dans un bandeau noir au bas de l'écran, par-dessus les
+// cellules : il faut le repeindre tant qu'elles changent
+template <class Model>
+void AutomatonView<Model>::print(const char* text) {
+    gb.display.setColor(BLACK);
+    gb.display.fillRect(0, SCREEN_HEIGHT - BANNER, SCREEN_WIDTH, BANNER);
+    gb.display.setColor(WHITE);
+    gb.display.setCursor(1, SCREEN_HEIGHT - BANNER + 1);
+    gb.display.print(text);
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef GAME_OF_LIFE_BOUNDARY_H_
+#define GAME_OF_LIFE_BOUNDARY_H_
+
+#include "bootstrap.h"
+
+// Politiques de bord de l'univers, passées en paramètre de template :
+// les tests sur DEAD sont résolus à la compilation.
+//
+// Chaque politique indique aussi comment les colonnes (COLUMNS) et les
+// rangées (ROWS) se prolongent au-delà du bord, et porte un identifiant
+// (ID) qui permet à Automaton d'en changer à l'exécution. Seuls Torus et
+// DeadBorder fournissent DEAD et wrap() pour les autres moteurs.
+
+// prolongement d'une rangée (ou d'une colonne) au-delà du bord
+const uint8_t EDGE_DEAD    = 0;   // cellules mortes
+const uint8_t EDGE_WRAP    = 1;   // bord opposé
+const uint8_t EDGE_FLIP    = 2;   // bord opposé, retourné
+const uint8_t EDGE_REFLECT = 3;   // le bord lui-même, comme dans un miroir
+
+// L'univers est un tore : ce qui sort d'un côté rentre de l'autre.
+struct Torus
+{
+    static const uint8_t ID = 0;
+    static const uint8_t COLUMNS = EDGE_WRAP;
+    static const uint8_t ROWS = EDGE_WRAP;
+    static const bool DEAD = false;
+
+    // ramène la coordonnée i dans l'intervalle [1,n]
+    static bool wrap(size_t& i, size_t n) {
+        i = (i + n - 1) % n + 1;
+        return true;
+    }
+};
+
+// Bouteille de Klein : comme sur un tore, mais ce qui sort par le haut
+// rentre par le bas de l'autre côté de l'écran.
+struct KleinBottle
+{
+    static const uint8_t ID = 1;
+    static const uint8_t COLUMNS = EDGE_WRAP;
+    static const uint8_t ROWS = EDGE_FLIP;
+};
+
+// Cylindre : les côtés se rejoignent, le haut et le bas sont morts.
+struct Cylinder
+{
+    static const uint8_t ID = 2;
+    static const uint8_t COLUMNS = EDGE_WRAP;
+    static const uint8_t ROWS = EDGE_DEAD;
+};
+
+// L'univers est bordé de cellules mortes.
+struct DeadBorder
+{
+    static const uint8_t ID = 3;
+    static const uint8_t COLUMNS = EDGE_DEAD;
+    static const uint8_t ROWS = EDGE_DEAD;
+    static const bool DEAD = true;
+
+    // une coordonnée hors de l'intervalle [1,n] désigne la bordure
+    static bool wrap(size_t& i, size_t n) {
+        return i >= 1 && i <= n;
+    }
+};
+
+// Les bords sont des miroirs : chaque cellule du bord a pour voisine,
+// au-delà, son propre reflet.
+struct Mirror
+{
+    static const uint8_t ID = 4;
+    static const uint8_t COLUMNS = EDGE_REFLECT;
+    static const uint8_t ROWS = EDGE_REFLECT;
+};
+
+#endif
@@ -2,16 +2,34 @@
 #define GAME_OF_LIFE_EDITOR_H_
 
 #include "bootstrap.h"
+#include "Boundary.h"
 
+// Le curseur d'édition se déplace sur les cellules (1,1) à (W,H) : il suit
+// la topologie de l'univers, que Boundary ne fait qu'initialiser. Il passe
+// d'un bord à l'autre là où les bords se rejoignent (retourné au passage
+// sur une bouteille de Klein), et s'arrête sur un bord mort ou un miroir.
+template <uint8_t W, uint8_t H, class Boundary>
 class Editor
 {
     private:
 
         uint8_t x, y;
+        // prolongement des colonnes et des rangées (EDGE_*)
+        uint8_t columns, rows;
+
+        template <class T> void use();
 
     public:
 
+        static const uint8_t WIDTH  = W;
+        static const uint8_t HEIGHT = H;
+
         Editor(uint8_t x, uint8_t y);
+        bool setTopology(uint8_t id);
+        bool wrapsColumns();
+        bool wrapsRows();
+        bool flipsColumns();
+        bool flipsRows();
         uint8_t getX();
         uint8_t getY();
         void up();
@@ -20,4 +38,113 @@ class Editor
         void right();
 };
 
-#endif
\ No newline at end of file
+template <uint8_t W, uint8_t H, class Boundary>
+Editor<W,H,Boundary>::Editor(uint8_t x, uint8_t y) : x(x), y(y) {
+    this->template use<Boundary>();
+}
+
+// mêmes identifiants que Automaton::setTopology
+template <uint8_t W, uint8_t H, class Boundary>
+bool Editor<W,H,Boundary>::setTopology(uint8_t id) {
+    switch (id) {
+        case Torus::ID:       this->template use<Torus>();       break;
+        case KleinBottle::ID: this->template use<KleinBottle>(); break;
+        case Cylinder::ID:    this->template use<Cylinder>();    break;
+        case DeadBorder::ID:  this->template use<DeadBorder>();  break;
+        case Mirror::ID:      this->template use<Mirror>();      break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+template <class T>
+void Editor<W,H,Boundary>::use() {
+    this->columns = T::COLUMNS;
+    this->rows = T::ROWS;
+}
+
+// le curseur passe-t-il du bord gauche au bord droit ?
+template <uint8_t W, uint8_t H, class Boundary>
+bool Editor<W,H,Boundary>::wrapsColumns() {
+    return this->columns == EDGE_WRAP || this->columns == EDGE_FLIP;
+}
+
+// ... et du haut en bas ?
+template <uint8_t W, uint8_t H, class Boundary>
+bool Editor<W,H,Boundary>::wrapsRows() {
+    return this->rows == EDGE_WRAP || this->rows == EDGE_FLIP;
+}
+
+// en passant d'un côté à l'autre, la colonne retourne la rangée
+template <uint8_t W, uint8_t H, class Boundary>
+bool Editor<W,H,Boundary>::flipsColumns() {
+    return this->columns == EDGE_FLIP;
+}
+
+// en passant du haut en bas, la rangée retourne la colonne
+template <uint8_t W, uint8_t H, class Boundary>
+bool Editor<W,H,Boundary>::flipsRows() {
+    return this->rows == EDGE_FLIP;
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+uint8_t Editor<W,H,Boundary>::getX() {
+    return this->x;
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+uint8_t Editor<W,H,Boundary>::getY() {
+    return this->y;
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+void Editor<W,H,Boundary>::up() {
+    if (this->y > 1) {
+        this->y--;
+    } else if (this->wrapsRows()) {
+        this->y = H;
+        if (this->flipsRows()) {
+            this->x = W+1 - this->x;
+        }
+    }
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+void Editor<W,H,Boundary>::down() {
+    if (this->y < H) {
+        this->y++;
+    } else if (this->wrapsRows()) {
+        this->y = 1;
+        if (this->flipsRows()) {
+            this->x = W+1 - this->x;
+        }
+    }
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+void Editor<W,H,Boundary>::left() {
+    if (this->x > 1) {
+        this->x--;
+    } else if (this->wrapsColumns()) {
+        this->x = W;
+        if (this->flipsColumns()) {
+            this->y = H+1 - this->y;
+        }
+    }
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+void Editor<W,H,Boundary>::right() {
+    if (this->x < W) {
+        this->x++;
+    } else if (this->wrapsColumns()) {
+        this->x = 1;
+        if (this->flipsColumns()) {
+            this->y = H+1 - this->y;
+        }
+    }
+}
+
+#endif
@@ -1,6 +1,6 @@
 #include "EditorController.h"
 
-EditorController::EditorController(Editor* model, EditorView* view, AutomatonController* automatonController) : model(model), view(view), automatonController(automatonController) {
+EditorController::EditorController(UniverseEditor* model, UniverseEditorView* view, AutomatonController* automatonController) : model(model), view(view), automatonController(automatonController) {
     
 }
 
@@ -9,7 +9,7 @@ void EditorController::begin() {
 }
 
 void EditorController::loop() {
-    Editor* m = this->model;
+    UniverseEditor* m = this->model;
     AutomatonController* ac = this->automatonController;
 
     if (gb.buttons.repeat(BUTTON_A, 1)) {
@@ -31,7 +31,12 @@ void EditorController::loop() {
     this->update();
 }
 
+// le curseur suit la topologie de l'univers
+bool EditorController::setTopology(uint8_t id) {
+    return this->model->setTopology(id);
+}
+
+// l'univers reste à l'écran tel quel : seul le curseur est redessiné
 void EditorController::update() {
-    this->automatonController->update();
     this->view->draw();
 }
\ No newline at end of file
@@ -1,23 +1,23 @@
 #ifndef GAME_OF_LIFE_EDITOR_CONTROLLER_H_
 #define GAME_OF_LIFE_EDITOR_CONTROLLER_H_
 
-#include "Editor.h"
-#include "EditorView.h"
+#include "Universe.h"
 #include "AutomatonController.h"
 
 class EditorController
 {
     private:
 
-        Editor* model;
-        EditorView* view;
+        UniverseEditor* model;
+        UniverseEditorView* view;
         AutomatonController* automatonController;
 
     public:
 
-        EditorController(Editor* model, EditorView* view, AutomatonController* automatonController);
+        EditorController(UniverseEditor* model, UniverseEditorView* view, AutomatonController* automatonController);
         void begin();
         void loop();
+        bool setTopology(uint8_t id);
         void update();
 };
 
@@ -2,23 +2,125 @@
 #define GAME_OF_LIFE_EDITOR_VIEW_H_
 
 #include "bootstrap.h"
-#include "Editor.h"
 
+// Le curseur est dessiné par-dessus l'univers déjà affiché par Canvas (la
+// vue de l'univers), qui n'est pas redessiné : pour effacer le curseur,
+// Canvas rétablit seulement les pixels qu'il recouvrait.
+template <class Cursor, class Canvas>
 class EditorView
 {
     private:
 
         static const Color PALETTE[];
         static const uint8_t SHAPE[];
+        static const uint8_t W = Cursor::WIDTH;
+        static const uint8_t H = Cursor::HEIGHT;
+        static const uint8_t SCALE = CellSize<W,H>::PIXELS;
+        static const uint8_t TFT_SCALE = CellSize<W,H,TFT_WIDTH,TFT_HEIGHT>::PIXELS;
 
-        Editor* model;
+        Cursor* model;
+        Canvas* canvas;
         uint8_t clock;
-        void drawShape();
+        // cellule sur laquelle le curseur est affiché (x nul s'il ne l'est pas)
+        uint8_t x, y;
+        void drawShape(uint8_t cx, uint8_t cy, bool erase);
 
     public:
 
-        EditorView(Editor* model);
+        EditorView(Cursor* model, Canvas* canvas);
         void draw();
 };
 
-#endif
\ No newline at end of file
+template <class Cursor, class Canvas>
+const Color EditorView<Cursor,Canvas>::PALETTE[] = {
+    WHITE,
+    LIGHTBLUE
+};
+
+template <class Cursor, class Canvas>
+const uint8_t EditorView<Cursor,Canvas>::SHAPE[] = {
+    7, 7,
+    0, 0, 2, 2, 2, 0, 0,
+    0, 0, 0, 1, 0, 0, 0,
+    2, 0, 0, 0, 0, 0, 2,
+    2, 1, 0, 0, 0, 1, 2,
+    2, 0, 0, 0, 0, 0, 2,
+    0, 0, 0, 1, 0, 0, 0,
+    0, 0, 2, 2, 2, 0, 0
+};
+
+template <class Cursor, class Canvas>
+EditorView<Cursor,Canvas>::EditorView(Cursor* model, Canvas* canvas) : model(model), canvas(canvas), clock(0), x(0), y(0) {
+
+}
+
+template <class Cursor, class Canvas>
+void EditorView<Cursor,Canvas>::draw() {
+    if (this->x) {
+        this->drawShape(this->x, this->y, true);
+        this->x = 0;
+    }
+    if (this->clock % 4 < 2) {
+        this->x = this->model->getX();
+        this->y = this->model->getY();
+        this->drawShape(this->x, this->y, false);
+    }
+
+    this->clock++;
+}
+
+// sans image dans gb.display, l'univers est envoyé directement à l'écran
+// (TftView) : le curseur y est alors dessiné lui aussi
+template <class Cursor, class Canvas>
+void EditorView<Cursor,Canvas>::drawShape(uint8_t cx, uint8_t cy, bool erase) {
+    bool tft = !gb.display.width();
+    uint8_t scale = tft ? TFT_SCALE : SCALE;
+    // centre du curseur, en pixels, au milieu de la cellule pointée
+    int16_t x = (cx - 1) * scale + scale/2;
+    int16_t y = (cy - 1) * scale + scale/2;
+    int16_t sw = W * scale;
+    int16_t sh = H * scale;
+    uint8_t w = SHAPE[0];
+    uint8_t h = SHAPE[1];
+    uint8_t dx = w/2;
+    uint8_t dy = h/2;
+    int16_t u,v;
+    uint8_t c;
+    size_t i,j;
+    for (i=0; i<h; i++) {
+        for (j=0; j<w; j++) {
+            c = SHAPE[2+j+i*w];
+            if (c) {
+                u = x + j - dx;
+                v = y + i - dy;
+
+                // le curseur déborde comme lui-même se déplace : là où les
+                // bords se rejoignent, et retourné s'ils se rejoignent ainsi
+                if ((u < 0 || u >= sw) && this->model->wrapsColumns()) {
+                    u = u < 0 ? u + sw : u - sw;
+                    if (this->model->flipsColumns()) {
+                        v = sh-1 - v;
+                    }
+                }
+                if ((v < 0 || v >= sh) && this->model->wrapsRows()) {
+                    v = v < 0 ? v + sh : v - sh;
+                    if (this->model->flipsRows()) {
+                        u = sw-1 - u;
+                    }
+                }
+
+                if (erase) {
+                    this->canvas->restore(u, v);
+                } else if (tft) {
+                    gb.tft.setColor(PALETTE[c-1]);
+                    gb.tft.drawPixel(u, v);
+                } else {
+                    gb.display.setColor(PALETTE[c-1]);
+                    gb.display.drawPixel(u, v);
+                }
+            }
+        }
+    }
+}
+
+#endif
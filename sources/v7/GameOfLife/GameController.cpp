@@ -4,7 +4,19 @@ const uint8_t GameController::STATE_SUSPENDED = 0;
 const uint8_t GameController::STATE_RUNNING   = 1;
 const uint8_t GameController::STATE_EDITING   = 2;
 
-GameController::GameController() : state(STATE_SUSPENDED) {
+// vitesses proposées, en générations par seconde : en dessous de la
+// fréquence d'affichage, certaines images n'avancent pas la simulation,
+// au-dessus, plusieurs générations sont calculées par image
+const uint8_t GameController::FRAME_RATE = 25;
+const uint16_t GameController::SPEEDS[] = {1, 2, 5, 10, 25, 50, 100, 250};
+const uint8_t GameController::SPEED_COUNT = sizeof(SPEEDS) / sizeof(SPEEDS[0]);
+const uint8_t GameController::DEFAULT_SPEED = 4;
+
+// temps de calcul disponible dans une image de 40 ms, depuis son début
+// (gb.update() compris), en microsecondes
+const uint32_t GameController::FRAME_BUDGET = 32000;
+
+GameController::GameController() : state(STATE_SUSPENDED), speed(DEFAULT_SPEED), credit(0), cost(1000), spent(0), dropping(false) {
     this->initAutomatonController();
     this->initEditorController();
     this->initLightController();
@@ -13,14 +25,16 @@ GameController::GameController() : state(STATE_SUSPENDED) {
 }
 
 void GameController::initAutomatonController() {
-    Automaton* automaton = new Automaton();
-    AutomatonView* automatonView = new AutomatonView(automaton);
+    // la vue prend possession de l'écran avant que l'univers ne soit alloué
+    UniverseView::claim();
+    Universe* automaton = new Universe();
+    UniverseView* automatonView = new UniverseView(automaton);
     this->automatonController = new AutomatonController(automaton, automatonView);
 }
 
 void GameController::initEditorController() {
-    Editor* editor = new Editor(W/2, H/2);
-    EditorView* editorView = new EditorView(editor);
+    UniverseEditor* editor = new UniverseEditor(Universe::WIDTH/2, Universe::HEIGHT/2);
+    UniverseEditorView* editorView = new UniverseEditorView(editor, this->automatonController->getView());
     this->editorController = new EditorController(editor, editorView, this->automatonController);
 }
 
@@ -39,6 +53,7 @@ void GameController::initUserController() {
 }
 
 void GameController::begin() {
+    gb.setFrameRate(FRAME_RATE);
     this->automatonController->begin();
     this->editorController->begin();
     this->lightController->begin();
@@ -52,32 +67,74 @@ void GameController::loop() {
     this->userController->loop();
 
     if (this->state == STATE_RUNNING) {
-        this->automatonController->loop();
+        this->run();
     } else if (this->state == STATE_EDITING) {
         this->editorController->loop();
     }
+
+    this->userController->showMessage();
 }
 
 void GameController::clear() {
     this->automatonController->clear();
 }
 
-void GameController::randomize() {
-    this->automatonController->randomize();
+void GameController::randomize(uint8_t density, uint8_t symmetry) {
+    this->automatonController->randomize(density, symmetry);
+}
+
+void GameController::replay() {
+    this->automatonController->replay();
+}
+
+uint32_t GameController::getSeed() {
+    return this->automatonController->getSeed();
 }
 
 void GameController::addPattern(const uint8_t* pattern, uint8_t x, uint8_t y) {
     this->automatonController->addPattern(pattern, x, y);
 }
 
+// durée moyenne d'une génération (calcul et dessin des changements), en
+// microsecondes, telle que la mesure run()
+uint32_t GameController::getCost() {
+    return this->cost;
+}
+
+// le moteur de l'univers peut refuser la règle ou la topologie : il garde
+// alors les siennes
+bool GameController::setRule(const char* rulestring) {
+    if (this->automatonController->setRule(rulestring)) {
+        return true;
+    }
+    this->soundController->playError();
+    return false;
+}
+
+bool GameController::setTopology(uint8_t id) {
+    if (this->automatonController->setTopology(id)) {
+        this->editorController->setTopology(id);
+        return true;
+    }
+    this->soundController->playError();
+    return false;
+}
+
+void GameController::pan(int8_t dx, int8_t dy) {
+    this->automatonController->pan(dx, dy);
+}
+
 void GameController::start() {
     this->state = STATE_RUNNING;
+    this->credit = 0;
+    this->dropping = false;
     this->soundController->playStart();
     this->lightController->breathe(100, .5);
 }
 
 void GameController::stop() {
     this->state = STATE_SUSPENDED;
+    this->automatonController->settle();
     this->soundController->playStop();
     this->lightController->flash(10, .25);
 }
@@ -88,6 +145,109 @@ void GameController::step() {
     this->automatonController->step();
 }
 
+void GameController::fastForward(uint16_t generations) {
+    this->soundController->playStep();
+    this->automatonController->fastForward(generations);
+}
+
+void GameController::faster() {
+    if (this->speed < SPEED_COUNT-1) {
+        this->speed++;
+        this->credit = 0;
+        this->soundController->playStep();
+    }
+}
+
+void GameController::slower() {
+    if (this->speed > 0) {
+        this->speed--;
+        this->credit = 0;
+        this->soundController->playStep();
+    }
+}
+
+// nombre de générations à calculer pour cette image : chaque image crédite
+// SPEEDS[speed] / FRAME_RATE génération, dont on retient la partie entière
+uint16_t GameController::schedule() {
+    uint16_t n;
+    this->credit += SPEEDS[this->speed];
+    n = this->credit / FRAME_RATE;
+    this->credit %= FRAME_RATE;
+    return n;
+}
+
+// calcule ce que permet le reste de l'image : les générations dues qui y
+// tiennent, les autres restant dues (voir lag()), ou, si une seule
+// génération le dépasse, une tranche de rangées d'une génération étalée sur
+// plusieurs images, que le moteur signale comme en cours ; l'image
+// suivante, et la lecture des boutons, ne sont donc jamais retardées
+void GameController::run() {
+    AutomatonController* ac = this->automatonController;
+    uint32_t elapsed = micros() - gb.frameStartMicros;
+    uint32_t budget = elapsed < FRAME_BUDGET ? FRAME_BUDGET - elapsed : 0;
+    uint32_t start,rows,fit;
+    uint16_t n = this->schedule();
+
+    if (!ac->isPending()) {
+        if (!n) {
+            this->lag(0);
+            return;
+        }
+        if (this->cost <= budget) {
+            fit = budget / this->cost;
+            if (n > fit) {
+                this->lag(n - fit);
+                n = fit;
+            } else {
+                this->lag(0);
+            }
+            start = micros();
+            ac->loop(n);
+            this->measure((micros() - start) / n);
+            return;
+        }
+        // la première génération due commence ici
+        n--;
+        this->spent = 0;
+    }
+    this->lag(n);
+
+    rows = Universe::HEIGHT * budget / this->cost;
+    if (rows < 1) {
+        rows = 1;
+    } else if (rows > Universe::HEIGHT) {
+        rows = Universe::HEIGHT;
+    }
+    start = micros();
+    if (ac->advance(rows)) {
+        this->measure(this->spent + micros() - start);
+    } else {
+        this->spent += micros() - start;
+    }
+}
+
+// les générations dues que l'image n'a pas pu calculer (late) sont reportées
+// sur les suivantes, mais jamais plus d'une image de générations : au-delà,
+// elles sont abandonnées, et les LED passent du vert à l'orange tant que la
+// simulation ne tient pas la vitesse choisie
+void GameController::lag(uint16_t late) {
+    uint32_t credit = this->credit + (uint32_t)late * FRAME_RATE;
+    bool dropping = credit > SPEEDS[this->speed];
+    this->credit = dropping ? SPEEDS[this->speed] : credit;
+    if (dropping != this->dropping) {
+        this->dropping = dropping;
+        this->lightController->tint(dropping ? 30 : 100);
+    }
+}
+
+// moyenne glissante (exponentielle, de poids 1/4) de la durée d'une génération
+void GameController::measure(uint32_t duration) {
+    this->cost = (3 * this->cost + duration) / 4;
+    if (!this->cost) {
+        this->cost = 1;
+    }
+}
+
 void GameController::startEdit() {
     this->state = STATE_EDITING;
     this->lightController->breathe(240, 2.0);
@@ -113,4 +273,8 @@ void GameController::lightOff() {
 
 void GameController::update() {
     this->automatonController->update();
+}
+
+void GameController::print(const char* text) {
+    this->automatonController->print(text);
 }
\ No newline at end of file
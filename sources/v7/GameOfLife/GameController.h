@@ -15,6 +15,11 @@ class GameController
         static const uint8_t STATE_SUSPENDED;
         static const uint8_t STATE_RUNNING;
         static const uint8_t STATE_EDITING;
+        static const uint8_t FRAME_RATE;
+        static const uint16_t SPEEDS[];
+        static const uint8_t SPEED_COUNT;
+        static const uint8_t DEFAULT_SPEED;
+        static const uint32_t FRAME_BUDGET;
 
         AutomatonController* automatonController;
         EditorController* editorController;
@@ -22,12 +27,26 @@ class GameController
         SoundController* soundController;
         UserController* userController;
         uint8_t state;
+        // vitesse de la simulation (indice dans SPEEDS) et générations dues,
+        // en 1/FRAME_RATE de génération
+        uint8_t speed;
+        uint16_t credit;
+        // durée moyenne d'une génération, en microsecondes, et temps déjà
+        // passé sur la génération étalée sur plusieurs images
+        uint32_t cost;
+        uint32_t spent;
+        // des générations dues ont été abandonnées
+        bool dropping;
 
         void initAutomatonController();
         void initEditorController();
         void initLightController();
         void initSoundController();
         void initUserController();
+        uint16_t schedule();
+        void run();
+        void measure(uint32_t duration);
+        void lag(uint16_t late);
 
     public:
 
@@ -35,17 +54,27 @@ class GameController
         void begin();
         void loop();
         void clear();
-        void randomize();
+        void randomize(uint8_t density, uint8_t symmetry);
+        void replay();
+        uint32_t getSeed();
+        uint32_t getCost();
         void addPattern(const uint8_t* pattern, uint8_t x, uint8_t y);
+        bool setRule(const char* rulestring);
+        bool setTopology(uint8_t id);
+        void pan(int8_t dx, int8_t dy);
         void start();
         void stop();
         void step();
+        void fastForward(uint16_t generations);
+        void faster();
+        void slower();
         void startEdit();
         void stopEdit();
         bool isWaiting();
         bool isEditing();
         void lightOff();
         void update();
+        void print(const char* text);
 };
 
 #endif
\ No newline at end of file
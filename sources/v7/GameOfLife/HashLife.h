@@ -0,0 +1,806 @@
+#ifndef GAME_OF_LIFE_HASH_LIFE_H_
+#define GAME_OF_LIFE_HASH_LIFE_H_
+
+#include "bootstrap.h"
+#include "Boundary.h"
+#include "Neighbourhood.h"
+#include "Rule.h"
+#include "Soup.h"
+
+// Moteur HashLife : l'univers est un quadtree dont les nœuds sont uniques
+// (table de hachage) et mémorisent leur avenir, ce qui permet de sauter
+// 2^k générations d'un coup. Il expose la même interface qu'Automaton,
+// complétée par jump(k).
+//
+// Sur un tore, c'est la fenêtre de W x H cellules qui fait foi : à chaque
+// saut, on reconstruit le plan pavé par cette fenêtre et on en extrait
+// la fenêtre résultante. Avec une bordure morte, l'univers devient au
+// contraire un plan infini, dont seule la fenêtre (1,1)-(W,H) est visible :
+// la bordure n'est pas imposée, ce qui en sort continue d'évoluer.
+template <uint8_t W, uint8_t H, class Boundary>
+class HashLife
+{
+    private:
+
+#ifdef ARDUINO
+        typedef uint16_t Index;
+        static const Index NODES = 768;
+        static const Index BUCKETS = 256;
+        static const uint8_t MAX_LEVEL = 30;
+#else
+        typedef uint32_t Index;
+        static const Index NODES = 1UL << 20;
+        static const Index BUCKETS = 1UL << 18;
+        static const uint8_t MAX_LEVEL = 60;
+#endif
+        typedef int64_t Coord;
+
+        // un nœud de niveau n couvre 2^n x 2^n cellules ; les feuilles
+        // (niveau 3) contiennent directement 8 rangées de 8 bits
+        static const uint8_t LEAF = 3;
+        static const uint8_t MARK = 0x80;
+        // plus petit niveau dont la moitié couvre la fenêtre
+        static const uint8_t SIZE = W > H ? W : H;
+        static const uint8_t TOP = SIZE <= 16 ? 5 : SIZE <= 32 ? 6 : SIZE <= 64 ? 7 : SIZE <= 128 ? 8 : 9;
+        static const uint8_t WORDS = (W + 31) / 32;
+        static const uint8_t TILES_Y = (H + 7) / 8;
+
+        struct Node
+        {
+            union {
+                Index child[4];   // nw, ne, sw, se
+                uint8_t rows[8];  // feuilles : bit i de rows[j] = cellule (i,j)
+            };
+            Index next;           // chaînage dans la table de hachage
+            Index result;         // centre du nœud, 2^step générations plus tard
+            uint8_t level;        // 0 pour un nœud libre
+            uint8_t step;         // bit 7 : marque du ramasse-miettes
+        };
+
+        // réserve de nœuds et table de hachage, allouées à part : sur PC,
+        // elles occupent plusieurs mégaoctets
+        Node* nodes;
+        Index* buckets;
+        Index free;
+        Index used;
+        Index empties[MAX_LEVEL+1];
+        // racine du plan infini, ou dernier plan pavé construit sur un tore
+        Index root;
+        // plus de nœud disponible : le calcul en cours est à reprendre
+        bool overflow;
+
+        // fenêtre visible, 1 bit par cellule
+        uint32_t cells[H][WORDS];
+        uint32_t changed[TILES_Y];
+        uint16_t birth;
+        uint16_t survival;
+
+        Index hash(const Node& n);
+        Index intern(Node& n);
+        Index join(Index nw, Index ne, Index sw, Index se);
+        Index leaf(const uint8_t* rows);
+        Index centre(Index n);
+        Index expand(Index n);
+        bool isCentred(Index n, uint8_t depth);
+        Index base(Index n, uint8_t k);
+        Index result(Index n, uint8_t k);
+        void reset();
+        void mark(Index n);
+        void collect(bool forget);
+        bool at(Coord x, Coord y);
+        Index build(uint8_t level, Coord x, Coord y);
+        Index setCell(Index n, Coord x, Coord y, bool alive);
+        void extract(Index n, Coord x, Coord y, uint32_t (*out)[WORDS], uint8_t ox, uint8_t oy);
+        void put(size_t x, size_t y, bool alive);
+        bool leap(uint8_t k, bool dense);
+        bool advance(uint8_t k);
+        void crawl();
+        void commit(uint32_t (*next)[WORDS]);
+
+    public:
+
+        static const uint8_t WIDTH  = W;
+        static const uint8_t HEIGHT = H;
+        static const uint8_t TILE   = 8;
+        typedef Boundary Topology;
+        typedef Moore Neighbourhood;
+
+        HashLife();
+        ~HashLife();
+        bool setRule(const char* rulestring);
+        bool setTopology(uint8_t id);
+        uint8_t getCell(size_t x, size_t y);
+        uint32_t getChangedTiles(uint8_t ty);
+        uint8_t getChangedCells(uint8_t y, uint8_t tx);
+        void getBounds(uint8_t& x, uint8_t& y, uint8_t& xsup, uint8_t& ysup);
+        bool pan(int8_t dx, int8_t dy);
+        void spawn(size_t x, size_t y);
+        void kill(size_t x, size_t y);
+        void clear();
+        void randomize(Soup& soup);
+        void addPattern(const uint8_t* pattern, uint8_t x, uint8_t y);
+        void step();
+        void step(uint16_t n);
+        bool stepRows(uint8_t rows);
+        bool isPending();
+        bool jump(uint8_t k);
+};
+
+template <uint8_t W, uint8_t H, class Boundary>
+HashLife<W,H,Boundary>::HashLife() {
+    this->nodes = new Node[NODES];
+    this->buckets = new Index[BUCKETS];
+    this->reset();
+    this->setRule(Rule::CONWAY);
+    this->clear();
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+HashLife<W,H,Boundary>::~HashLife() {
+    delete[] this->nodes;
+    delete[] this->buckets;
+}
+
+// HashLife ne connaît que deux états, et une règle B0 ferait naître
+// une infinité de cellules sur le plan
+template <uint8_t W, uint8_t H, class Boundary>
+bool HashLife<W,H,Boundary>::setRule(const char* rulestring) {
+    Rule rule;
+    if (!rule.parse(rulestring) || rule.getStates() > 2 || (rule.getBirth() & 1) || rule.isLarge() || !rule.isTotalistic() || rule.getNeighbourhood()) {
+        return false;
+    }
+    this->birth = rule.getBirth();
+    this->survival = rule.getSurvival();
+    // l'avenir mémorisé des nœuds ne vaut plus rien
+    this->collect(true);
+    return true;
+}
+
+// la topologie est fixée à la compilation
+template <uint8_t W, uint8_t H, class Boundary>
+bool HashLife<W,H,Boundary>::setTopology(uint8_t id) {
+    return id == Boundary::ID;
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+uint8_t HashLife<W,H,Boundary>::getCell(size_t x, size_t y) {
+    if (!Boundary::wrap(x, W) || !Boundary::wrap(y, H)) {
+        return 0;
+    }
+    return (this->cells[y-1][(x-1) / 32] >> ((x-1) % 32)) & 1;
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+uint32_t HashLife<W,H,Boundary>::getChangedTiles(uint8_t ty) {
+    return this->changed[ty];
+}
+
+// au mieux, une tuile changée entière
+template <uint8_t W, uint8_t H, class Boundary>
+uint8_t HashLife<W,H,Boundary>::getChangedCells(uint8_t y, uint8_t tx) {
+    return (this->changed[y / TILE] >> tx) & 1 ? 0xFF : 0;
+}
+
+// seule la fenêtre est exportée : c'est toute la grille
+template <uint8_t W, uint8_t H, class Boundary>
+void HashLife<W,H,Boundary>::getBounds(uint8_t& x, uint8_t& y, uint8_t& xsup, uint8_t& ysup) {
+    x = y = 0;
+    xsup = W;
+    ysup = H;
+}
+
+// la fenêtre exportée reste ancrée en (1,1), sur le tore comme sur le plan
+template <uint8_t W, uint8_t H, class Boundary>
+bool HashLife<W,H,Boundary>::pan(int8_t dx, int8_t dy) {
+    return false;
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+void HashLife<W,H,Boundary>::spawn(size_t x, size_t y) {
+    this->put(x, y, true);
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+void HashLife<W,H,Boundary>::kill(size_t x, size_t y) {
+    this->put(x, y, false);
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+void HashLife<W,H,Boundary>::clear() {
+    memset(this->cells, 0, sizeof(this->cells));
+    memset(this->changed, 0xFF, sizeof(this->changed));
+    this->root = this->empties[TOP];
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+void HashLife<W,H,Boundary>::randomize(Soup& soup) {
+    soup.fill(this->cells[0], W, H);
+    memset(this->changed, 0xFF, sizeof(this->changed));
+    if (Boundary::DEAD) {
+        // le plan se réduit désormais à la fenêtre
+        this->root = this->build(TOP, -((Coord)1 << (TOP-1)), -((Coord)1 << (TOP-1)));
+    }
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+void HashLife<W,H,Boundary>::addPattern(const uint8_t* pattern, uint8_t x, uint8_t y) {
+    uint8_t w = pattern[0];
+    uint8_t h = pattern[1];
+    uint8_t c;
+    size_t i,j;
+    for (i=0; i<h; i++) {
+        for (j=0; j<w; j++) {
+            c = pattern[2 + i*w + j];
+            if (c & 0xF0) { this->put(x+2*j, y+i, true); }
+            if (c & 0x0F) { this->put(x+2*j+1, y+i, true); }
+        }
+    }
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+void HashLife<W,H,Boundary>::step() {
+    memset(this->changed, 0, sizeof(this->changed));
+    this->leap(0, true);
+}
+
+// n générations en autant de sauts que n a de bits à 1, du plus long au
+// plus court
+template <uint8_t W, uint8_t H, class Boundary>
+void HashLife<W,H,Boundary>::step(uint16_t n) {
+    uint8_t k;
+    memset(this->changed, 0, sizeof(this->changed));
+    for (k=16; k--; ) {
+        if ((n >> k) & 1) {
+            this->leap(k, true);
+        }
+    }
+}
+
+// avance de 2^k générations ; renvoie false si le motif est trop grand
+// pour la réserve de nœuds, l'univers n'ayant alors avancé que d'une
+// partie du saut
+template <uint8_t W, uint8_t H, class Boundary>
+bool HashLife<W,H,Boundary>::jump(uint8_t k) {
+    memset(this->changed, 0, sizeof(this->changed));
+    return this->leap(k, false);
+}
+
+// saut de 2^k générations, dont les tuiles modifiées s'ajoutent à celles
+// des sauts précédents ; faute de mémoire, on libère les nœuds inutiles
+// puis on se replie sur deux sauts de 2^(k-1) générations, et en dernier
+// recours, avec dense, sur le calcul direct d'une génération (step() et
+// step(n) ne peuvent donc pas échouer)
+template <uint8_t W, uint8_t H, class Boundary>
+bool HashLife<W,H,Boundary>::leap(uint8_t k, bool dense) {
+    // sur un tore, le plan pavé ne permet pas de sauter plus de
+    // 2^(TOP-2) générations d'un coup
+    if (!Boundary::DEAD && k > TOP-2) {
+        return this->leap(k-1, dense) && this->leap(k-1, dense);
+    }
+    if (this->advance(k)) {
+        if (this->used > NODES / 4 * 3) {
+            this->collect(false);
+        }
+        return true;
+    }
+    this->collect(true);
+    if (this->advance(k)) {
+        return true;
+    }
+    this->collect(true);
+    if (k > 0) {
+        return this->leap(k-1, dense) && this->leap(k-1, dense);
+    }
+    if (dense) {
+        this->crawl();
+    }
+    return dense;
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+bool HashLife<W,H,Boundary>::advance(uint8_t k) {
+    uint32_t next[H][WORDS];
+    Index n,r;
+    Coord half;
+
+    this->overflow = false;
+    memset(next, 0, sizeof(next));
+
+    if (Boundary::DEAD) {
+        // le motif doit tenir dans le quart central de la racine pour que
+        // rien ne sorte du résultat, qui en couvre la moitié et doit
+        // encore contenir la fenêtre
+        n = this->root;
+        while (this->nodes[n].level < k+3 || this->nodes[n].level <= TOP || !this->isCentred(n, 2)) {
+            if (this->nodes[n].level == MAX_LEVEL) {
+                return false;
+            }
+            n = this->expand(n);
+        }
+        r = this->result(n, k);
+        // puis on retire les couronnes vides superflues
+        while (this->nodes[r].level > TOP && this->isCentred(r, 1)) {
+            r = this->centre(r);
+        }
+        if (this->overflow) {
+            return false;
+        }
+        this->root = r;
+        half = (Coord)1 << (this->nodes[r].level-1);
+        this->extract(r, -half, -half, next, 0, 0);
+    } else {
+        // le résultat du plan pavé commence à la cellule (2^(TOP-2), 2^(TOP-2))
+        n = this->build(TOP, 0, 0);
+        r = this->result(n, k);
+        if (this->overflow) {
+            return false;
+        }
+        this->root = n;
+        this->extract(r, 0, 0, next, (1 << (TOP-2)) % W, (1 << (TOP-2)) % H);
+    }
+
+    this->commit(next);
+    return true;
+}
+
+// une génération calculée cellule par cellule sur la fenêtre, quand même
+// celle-ci ne tient pas dans la réserve de nœuds ; l'arbre est ensuite
+// reconstruit à partir de la fenêtre : sur le plan, ce qui en sortait est
+// perdu
+template <uint8_t W, uint8_t H, class Boundary>
+void HashLife<W,H,Boundary>::crawl() {
+    uint32_t next[H][WORDS];
+    Coord x,y,i,j;
+    uint8_t s;
+    memset(next, 0, sizeof(next));
+    for (y=0; y<H; y++) {
+        for (x=0; x<W; x++) {
+            s = 0;
+            for (j=-1; j<=1; j++) {
+                for (i=-1; i<=1; i++) {
+                    if ((i || j) && this->at(x+i, y+j)) {
+                        s++;
+                    }
+                }
+            }
+            if ((this->at(x, y) ? this->survival : this->birth) & (1 << s)) {
+                next[y][x / 32] |= 1UL << (x % 32);
+            }
+        }
+    }
+    this->commit(next);
+    this->reset();
+    if (Boundary::DEAD) {
+        this->root = this->build(TOP, -((Coord)1 << (TOP-1)), -((Coord)1 << (TOP-1)));
+    }
+}
+
+// remplace la fenêtre par next, en relevant les tuiles modifiées
+template <uint8_t W, uint8_t H, class Boundary>
+void HashLife<W,H,Boundary>::commit(uint32_t (*next)[WORDS]) {
+    uint32_t d;
+    size_t x,y;
+    uint8_t b;
+    for (y=0; y<H; y++) {
+        for (x=0; x<WORDS; x++) {
+            d = next[y][x] ^ this->cells[y][x];
+            for (b=0; d; b++, d >>= 8) {
+                if (d & 0xFF) {
+                    this->changed[y / TILE] |= 1UL << (x*4 + b);
+                }
+            }
+        }
+    }
+    memcpy(this->cells, next, sizeof(this->cells));
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+typename HashLife<W,H,Boundary>::Index HashLife<W,H,Boundary>::hash(const Node& n) {
+    uint32_t h = n.level;
+    uint8_t i;
+    if (n.level == LEAF) {
+        for (i=0; i<8; i++) {
+            h = h*31 + n.rows[i];
+        }
+    } else {
+        for (i=0; i<4; i++) {
+            h = h*0x9E3779B1UL + n.child[i];
+        }
+    }
+    return (h ^ (h >> 16)) % BUCKETS;
+}
+
+// renvoie le nœud identique à n s'il existe, ou en crée une copie ;
+// faute de place, on renvoie le nœud vide du même niveau
+template <uint8_t W, uint8_t H, class Boundary>
+typename HashLife<W,H,Boundary>::Index HashLife<W,H,Boundary>::intern(Node& n) {
+    Index h = this->hash(n);
+    Index i;
+    Node* p;
+    for (i=this->buckets[h]; i; i=p->next) {
+        p = this->nodes + i;
+        if (p->level == n.level && memcmp(p->child, n.child, sizeof(n.child)) == 0) {
+            return i;
+        }
+    }
+    if (!this->free) {
+        this->overflow = true;
+        return this->empties[n.level];
+    }
+    i = this->free;
+    p = this->nodes + i;
+    this->free = p->next;
+    this->used++;
+    memcpy(p->child, n.child, sizeof(n.child));
+    p->level = n.level;
+    p->result = 0;
+    p->step = 0;
+    p->next = this->buckets[h];
+    this->buckets[h] = i;
+    return i;
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+typename HashLife<W,H,Boundary>::Index HashLife<W,H,Boundary>::join(Index nw, Index ne, Index sw, Index se) {
+    Node n;
+    n.child[0] = nw;
+    n.child[1] = ne;
+    n.child[2] = sw;
+    n.child[3] = se;
+    n.level = this->nodes[nw].level + 1;
+    return this->intern(n);
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+typename HashLife<W,H,Boundary>::Index HashLife<W,H,Boundary>::leaf(const uint8_t* rows) {
+    Node n;
+    memset(n.child, 0, sizeof(n.child));
+    memcpy(n.rows, rows, 8);
+    n.level = LEAF;
+    return this->intern(n);
+}
+
+// nœud central, de niveau inférieur
+template <uint8_t W, uint8_t H, class Boundary>
+typename HashLife<W,H,Boundary>::Index HashLife<W,H,Boundary>::centre(Index n) {
+    const Index* c = this->nodes[n].child;
+    uint8_t rows[8];
+    uint8_t i;
+    if (this->nodes[n].level == LEAF+1) {
+        for (i=0; i<4; i++) {
+            rows[i]   = (this->nodes[c[0]].rows[i+4] >> 4) | (this->nodes[c[1]].rows[i+4] << 4);
+            rows[i+4] = (this->nodes[c[2]].rows[i] >> 4)   | (this->nodes[c[3]].rows[i] << 4);
+        }
+        return this->leaf(rows);
+    }
+    return this->join(this->nodes[c[0]].child[3], this->nodes[c[1]].child[2], this->nodes[c[2]].child[1], this->nodes[c[3]].child[0]);
+}
+
+// nœud de niveau supérieur, de même centre, entouré de cellules mortes
+template <uint8_t W, uint8_t H, class Boundary>
+typename HashLife<W,H,Boundary>::Index HashLife<W,H,Boundary>::expand(Index n) {
+    const Index* c = this->nodes[n].child;
+    Index e = this->empties[this->nodes[n].level - 1];
+    return this->join(this->join(e, e, e, c[0]), this->join(e, e, c[1], e), this->join(e, c[2], e, e), this->join(c[3], e, e, e));
+}
+
+// toutes les cellules du nœud sont-elles dans son carré central de côté
+// 2^(niveau - depth) ?
+template <uint8_t W, uint8_t H, class Boundary>
+bool HashLife<W,H,Boundary>::isCentred(Index n, uint8_t depth) {
+    const Node* c;
+    Index e;
+    uint8_t q,i;
+    // dans chaque quadrant q, on descend vers le centre : seul le
+    // sous-quadrant intérieur, 3-q, peut contenir des cellules vivantes
+    for (q=0; q<4; q++) {
+        c = this->nodes + this->nodes[n].child[q];
+        for (i=0; i<depth; i++) {
+            if (c->level == LEAF) {
+                return false;
+            }
+            e = this->empties[c->level - 1];
+            if (c->child[q] != e || c->child[q ^ 1] != e || c->child[q ^ 2] != e) {
+                return false;
+            }
+            c = this->nodes + c->child[3-q];
+        }
+    }
+    return true;
+}
+
+// cas de base : un nœud de 16x16 cellules, dont le centre de 8x8
+// cellules est calculé cellule par cellule sur 2^k <= 4 générations
+template <uint8_t W, uint8_t H, class Boundary>
+typename HashLife<W,H,Boundary>::Index HashLife<W,H,Boundary>::base(Index n, uint8_t k) {
+    const Index* c = this->nodes[n].child;
+    uint16_t rows[16];
+    uint16_t next[16];
+    uint8_t out[8];
+    uint8_t i,x,y,g,s;
+    uint16_t v;
+    for (i=0; i<8; i++) {
+        rows[i]   = this->nodes[c[0]].rows[i] | (this->nodes[c[1]].rows[i] << 8);
+        rows[i+8] = this->nodes[c[2]].rows[i] | (this->nodes[c[3]].rows[i] << 8);
+    }
+    // à chaque génération, la zone exacte perd une cellule de chaque côté
+    for (g=0; g<(1 << k); g++) {
+        memset(next, 0, sizeof(next));
+        for (y=1; y<15; y++) {
+            for (x=1; x<15; x++) {
+                s = 0;
+                for (i=0; i<3; i++) {
+                    v = (rows[y-1+i] >> (x-1)) & 7;
+                    s += (v & 1) + ((v >> 1) & 1) + (v >> 2);
+                }
+                if ((rows[y] >> x) & 1) {
+                    s--;
+                    v = (this->survival >> s) & 1;
+                } else {
+                    v = (this->birth >> s) & 1;
+                }
+                next[y] |= v << x;
+            }
+        }
+        memcpy(rows, next, sizeof(rows));
+    }
+    for (i=0; i<8; i++) {
+        out[i] = rows[i+4] >> 4;
+    }
+    return this->leaf(out);
+}
+
+// centre du nœud n, 2^k générations plus tard (k <= niveau - 2)
+template <uint8_t W, uint8_t H, class Boundary>
+typename HashLife<W,H,Boundary>::Index HashLife<W,H,Boundary>::result(Index n, uint8_t k) {
+    Node* p = this->nodes + n;
+    Index q[9];
+    Index a,b,c,d,r;
+    uint8_t i,level = p->level;
+    bool full = k == level-2;
+
+    if (p->result && (p->step & ~MARK) == k) {
+        return p->result;
+    }
+    if (n == this->empties[level]) {
+        return this->empties[level-1];
+    }
+    if (level == LEAF+1) {
+        r = this->base(n, k);
+    } else {
+        // les 9 sous-carrés de niveau inférieur, qui se chevauchent
+        a = p->child[0]; b = p->child[1]; c = p->child[2]; d = p->child[3];
+        q[0] = a;
+        q[1] = this->join(this->nodes[a].child[1], this->nodes[b].child[0], this->nodes[a].child[3], this->nodes[b].child[2]);
+        q[2] = b;
+        q[3] = this->join(this->nodes[a].child[2], this->nodes[a].child[3], this->nodes[c].child[0], this->nodes[c].child[1]);
+        q[4] = this->centre(n);
+        q[5] = this->join(this->nodes[b].child[2], this->nodes[b].child[3], this->nodes[d].child[0], this->nodes[d].child[1]);
+        q[6] = c;
+        q[7] = this->join(this->nodes[c].child[1], this->nodes[d].child[0], this->nodes[c].child[3], this->nodes[d].child[2]);
+        q[8] = d;
+        // à pleine vitesse, chaque moitié du saut est faite par un étage de
+        // la récursion ; sinon, le premier étage se contente de recentrer
+        for (i=0; i<9; i++) {
+            q[i] = full ? this->result(q[i], k-1) : this->centre(q[i]);
+        }
+        i = full ? k-1 : k;
+        r = this->join(this->result(this->join(q[0], q[1], q[3], q[4]), i),
+                       this->result(this->join(q[1], q[2], q[4], q[5]), i),
+                       this->result(this->join(q[3], q[4], q[6], q[7]), i),
+                       this->result(this->join(q[4], q[5], q[7], q[8]), i));
+    }
+    // un résultat obtenu sans mémoire suffisante n'est pas fiable
+    if (!this->overflow) {
+        p->result = r;
+        p->step = (p->step & MARK) | k;
+    }
+    return r;
+}
+
+// vide la réserve de nœuds et recrée les nœuds vides de chaque niveau
+template <uint8_t W, uint8_t H, class Boundary>
+void HashLife<W,H,Boundary>::reset() {
+    uint8_t rows[8];
+    uint8_t l;
+    Index i;
+    memset(this->buckets, 0, BUCKETS * sizeof(Index));
+    // le nœud 0 n'est jamais utilisé : il marque l'absence de nœud
+    this->free = 0;
+    for (i=NODES-1; i>0; i--) {
+        this->nodes[i].level = 0;
+        this->nodes[i].next = this->free;
+        this->free = i;
+    }
+    this->used = 0;
+    this->overflow = false;
+    memset(rows, 0, sizeof(rows));
+    this->empties[LEAF] = this->leaf(rows);
+    for (l=LEAF+1; l<=MAX_LEVEL; l++) {
+        this->empties[l] = this->join(this->empties[l-1], this->empties[l-1], this->empties[l-1], this->empties[l-1]);
+    }
+    this->root = this->empties[TOP];
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+void HashLife<W,H,Boundary>::mark(Index n) {
+    Node* p = this->nodes + n;
+    uint8_t i;
+    if (p->step & MARK) {
+        return;
+    }
+    p->step |= MARK;
+    if (p->level > LEAF) {
+        for (i=0; i<4; i++) {
+            this->mark(p->child[i]);
+        }
+    }
+}
+
+// ramasse-miettes : libère les nœuds qui ne sont plus accessibles depuis
+// la racine ; avec forget, les résultats mémorisés sont aussi oubliés
+template <uint8_t W, uint8_t H, class Boundary>
+void HashLife<W,H,Boundary>::collect(bool forget) {
+    Node* p;
+    Index i,h;
+    uint8_t l;
+    for (l=LEAF; l<=MAX_LEVEL; l++) {
+        this->mark(this->empties[l]);
+    }
+    this->mark(this->root);
+    for (i=1; i<NODES; i++) {
+        p = this->nodes + i;
+        if ((p->step & MARK) && p->result && (forget || !(this->nodes[p->result].step & MARK))) {
+            p->result = 0;
+        }
+    }
+    memset(this->buckets, 0, BUCKETS * sizeof(Index));
+    this->free = 0;
+    this->used = 0;
+    for (i=NODES-1; i>0; i--) {
+        p = this->nodes + i;
+        if (p->step & MARK) {
+            p->step &= ~MARK;
+            h = this->hash(*p);
+            p->next = this->buckets[h];
+            this->buckets[h] = i;
+            this->used++;
+        } else {
+            p->level = 0;
+            p->next = this->free;
+            this->free = i;
+        }
+    }
+}
+
+// cellule (x,y) du plan, à partir de 0 : sur un tore, le plan est pavé
+// par la fenêtre
+template <uint8_t W, uint8_t H, class Boundary>
+bool HashLife<W,H,Boundary>::at(Coord x, Coord y) {
+    if (Boundary::DEAD) {
+        if (x < 0 || x >= W || y < 0 || y >= H) {
+            return false;
+        }
+    } else {
+        x = (x % W + W) % W;
+        y = (y % H + H) % H;
+    }
+    return (this->cells[y][x / 32] >> (x % 32)) & 1;
+}
+
+// construit le nœud de niveau level dont le coin haut gauche est la
+// cellule (x,y) du plan
+template <uint8_t W, uint8_t H, class Boundary>
+typename HashLife<W,H,Boundary>::Index HashLife<W,H,Boundary>::build(uint8_t level, Coord x, Coord y) {
+    Coord half = (Coord)1 << (level-1);
+    uint8_t rows[8];
+    uint8_t i,j;
+    if (Boundary::DEAD && (x >= W || y >= H || x + 2*half <= 0 || y + 2*half <= 0)) {
+        return this->empties[level];
+    }
+    if (level == LEAF) {
+        memset(rows, 0, sizeof(rows));
+        for (j=0; j<8; j++) {
+            for (i=0; i<8; i++) {
+                rows[j] |= this->at(x+i, y+j) << i;
+            }
+        }
+        return this->leaf(rows);
+    }
+    return this->join(this->build(level-1, x, y), this->build(level-1, x+half, y),
+                      this->build(level-1, x, y+half), this->build(level-1, x+half, y+half));
+}
+
+// copie du nœud n où la cellule (x,y), relative à son coin haut gauche,
+// prend l'état alive
+template <uint8_t W, uint8_t H, class Boundary>
+typename HashLife<W,H,Boundary>::Index HashLife<W,H,Boundary>::setCell(Index n, Coord x, Coord y, bool alive) {
+    Index c[4];
+    uint8_t rows[8];
+    uint8_t q;
+    Coord half;
+    if (this->nodes[n].level == LEAF) {
+        memcpy(rows, this->nodes[n].rows, 8);
+        rows[y] = (rows[y] & ~(1 << x)) | (alive << x);
+        return this->leaf(rows);
+    }
+    half = (Coord)1 << (this->nodes[n].level-1);
+    memcpy(c, this->nodes[n].child, sizeof(c));
+    q = (y >= half) * 2 + (x >= half);
+    c[q] = this->setCell(c[q], x % half, y % half, alive);
+    return this->join(c[0], c[1], c[2], c[3]);
+}
+
+// recopie dans out les cellules vivantes du nœud n, dont le coin haut
+// gauche est en (x,y), qui tombent dans la fenêtre ; sur un tore, la
+// fenêtre commence à la cellule (ox,oy)
+template <uint8_t W, uint8_t H, class Boundary>
+void HashLife<W,H,Boundary>::extract(Index n, Coord x, Coord y, uint32_t (*out)[WORDS], uint8_t ox, uint8_t oy) {
+    const Node* p = this->nodes + n;
+    Coord half,i,j;
+    size_t u,v;
+    if (n == this->empties[p->level]) {
+        return;
+    }
+    half = (Coord)1 << (p->level-1);
+    if (x >= W || y >= H || x + 2*half <= 0 || y + 2*half <= 0) {
+        return;
+    }
+    if (p->level == LEAF) {
+        for (j=0; j<8; j++) {
+            for (i=0; i<8; i++) {
+                if (((p->rows[j] >> i) & 1) && x+i >= 0 && x+i < W && y+j >= 0 && y+j < H) {
+                    u = (x + i + ox) % W;
+                    v = (y + j + oy) % H;
+                    out[v][u / 32] |= 1UL << (u % 32);
+                }
+            }
+        }
+        return;
+    }
+    this->extract(p->child[0], x, y, out, ox, oy);
+    this->extract(p->child[1], x+half, y, out, ox, oy);
+    this->extract(p->child[2], x, y+half, out, ox, oy);
+    this->extract(p->child[3], x+half, y+half, out, ox, oy);
+}
+
+// modifie la cellule (x,y) de la fenêtre, et sur le plan celle de l'arbre
+template <uint8_t W, uint8_t H, class Boundary>
+void HashLife<W,H,Boundary>::put(size_t x, size_t y, bool alive) {
+    Coord half;
+    Index n;
+    if (!Boundary::wrap(x, W) || !Boundary::wrap(y, H)) {
+        return;
+    }
+    x--;
+    y--;
+    this->cells[y][x / 32] = (this->cells[y][x / 32] & ~(1UL << (x % 32))) | ((uint32_t)alive << (x % 32));
+    this->changed[y / TILE] |= 1UL << (x / TILE);
+    if (Boundary::DEAD) {
+        half = (Coord)1 << (this->nodes[this->root].level-1);
+        this->overflow = false;
+        n = this->setCell(this->root, x + half, y + half, alive);
+        if (this->overflow) {
+            this->collect(true);
+            this->overflow = false;
+            n = this->setCell(this->root, x + half, y + half, alive);
+        }
+        if (!this->overflow) {
+            this->root = n;
+        }
+    }
+}
+
+// la récursion ne s'interrompt pas : toute la génération est calculée
+template <uint8_t W, uint8_t H, class Boundary>
+bool HashLife<W,H,Boundary>::stepRows(uint8_t) {
+    this->step();
+    return true;
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+bool HashLife<W,H,Boundary>::isPending() {
+    return false;
+}
+
+#endif
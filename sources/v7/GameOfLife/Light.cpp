@@ -78,6 +78,11 @@ void Light::breathe(float hue, float period) {
     this->breatheIn = true;
 }
 
+// change la couleur de l'effet en cours sans le reprendre au début
+void Light::tint(float hue) {
+    this->hue = hue;
+}
+
 float Light::easeInOutQuad(float t, float b, float c, float d) {
     t /= d/2;
 	if (t < 1) return c/2*t*t + b;
@@ -36,6 +36,7 @@ class Light
         void off();
         void flash(float hue, float duration);
         void breathe(float hue, float period);
+        void tint(float hue);
         
 };
 
@@ -24,4 +24,8 @@ void LightController::flash(float hue, float duration) {
 
 void LightController::breathe(float hue, float period) {
     this->model->breathe(hue, period);
+}
+
+void LightController::tint(float hue) {
+    this->model->tint(hue);
 }
\ No newline at end of file
@@ -21,6 +21,7 @@ class LightController
         void off();
         void flash(float hue, float duration);
         void breathe(float hue, float period);
+        void tint(float hue);
 };
 
 #endif
\ No newline at end of file
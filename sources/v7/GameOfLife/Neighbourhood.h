@@ -0,0 +1,63 @@
+#ifndef GAME_OF_LIFE_NEIGHBOURHOOD_H_
+#define GAME_OF_LIFE_NEIGHBOURHOOD_H_
+
+#include "bootstrap.h"
+
+// Voisinages d'une cellule, passés en paramètre de template à Automaton :
+// chacun fournit son propre décompte, déroulé, sans test sur la forme du
+// voisinage à chaque cellule.
+//
+// count() reçoit les cellules de même colonne dans la rangée du dessus
+// (a), la rangée courante (c) et celle du dessous (b), et f, le masque des
+// états actifs. EVEN et ODD désignent les voisines dans l'index de la
+// configuration 3x3 (voir Rule::setMasks()) sur les rangées paires et
+// impaires. Les règles d'un voisinage autre que Moore portent le suffixe
+// ID de Golly (B2/S013V, B2/S34H).
+
+// les 8 cellules qui entourent la cellule
+struct Moore
+{
+    static const char ID = 0;
+    static const bool HEX = false;
+    static const uint16_t EVEN = 0x1EF;
+    static const uint16_t ODD = 0x1EF;
+
+    static uint8_t count(const uint8_t* a, const uint8_t* c, const uint8_t* b, int8_t, uint16_t f) {
+        return ((f >> a[-1]) & 1) + ((f >> a[0]) & 1) + ((f >> a[1]) & 1)
+             + ((f >> c[-1]) & 1) + ((f >> c[1]) & 1)
+             + ((f >> b[-1]) & 1) + ((f >> b[0]) & 1) + ((f >> b[1]) & 1);
+    }
+};
+
+// les 4 cellules qui partagent un côté avec la cellule
+struct VonNeumann
+{
+    static const char ID = 'V';
+    static const bool HEX = false;
+    static const uint16_t EVEN = 0xAA;
+    static const uint16_t ODD = 0xAA;
+
+    static uint8_t count(const uint8_t* a, const uint8_t* c, const uint8_t* b, int8_t, uint16_t f) {
+        return ((f >> a[0]) & 1) + ((f >> c[-1]) & 1) + ((f >> c[1]) & 1) + ((f >> b[0]) & 1);
+    }
+};
+
+// grille hexagonale : les rangées impaires sont décalées d'une demi-cellule
+// vers la droite, et les voisines des rangées du dessus et du dessous sont
+// la cellule de même colonne et celle de la colonne side (-1 sur une
+// rangée paire, +1 sur une rangée impaire) ; sur un tore, H doit être pair
+struct Hexagonal
+{
+    static const char ID = 'H';
+    static const bool HEX = true;
+    static const uint16_t EVEN = 0x1EA;
+    static const uint16_t ODD = 0xAF;
+
+    static uint8_t count(const uint8_t* a, const uint8_t* c, const uint8_t* b, int8_t side, uint16_t f) {
+        return ((f >> a[0]) & 1) + ((f >> a[side]) & 1)
+             + ((f >> c[-1]) & 1) + ((f >> c[1]) & 1)
+             + ((f >> b[0]) & 1) + ((f >> b[side]) & 1);
+    }
+};
+
+#endif
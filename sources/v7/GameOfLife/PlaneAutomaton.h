@@ -0,0 +1,465 @@
+#ifndef GAME_OF_LIFE_PLANE_AUTOMATON_H_
+#define GAME_OF_LIFE_PLANE_AUTOMATON_H_
+
+#include "bootstrap.h"
+#include "Boundary.h"
+#include "Neighbourhood.h"
+#include "Rule.h"
+#include "Soup.h"
+
+// Moteur sur un plan sans bord : le plan est découpé en morceaux de 16x16
+// cellules (1 bit par cellule), pris dans une réserve de CHUNKS morceaux
+// allouée une fois pour toutes. Un morceau est créé dès qu'une cellule
+// vivante touche son bord, et rendu à la réserve après IDLE générations
+// sans cellule vivante ; quand la réserve est épuisée, les naissances hors
+// des morceaux existants sont perdues. Les cellules (1,1) à (W,H) sont
+// celles d'une fenêtre que l'on déplace sur le plan avec pan().
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+class PlaneAutomaton
+{
+    private:
+
+        static const uint8_t CHUNK = 16;
+        static const uint8_t BUCKETS = 64;
+        static const uint8_t NONE = 0xFF;
+        static const uint8_t IDLE = 16;
+        static const uint8_t TILES_Y = (H + 7) / 8;
+
+        struct Chunk
+        {
+            int16_t cx, cy;            // position du morceau, en morceaux
+            uint16_t rows[2][CHUNK];   // bit i de rows[parity][j] = cellule (i,j)
+            uint8_t next;              // chaînage dans la table ou la réserve
+            uint8_t idle;              // générations sans vie, NONE si libre
+        };
+
+        Chunk chunks[CHUNKS];
+        uint8_t buckets[BUCKETS];
+        uint8_t free;
+        // tampon des morceaux qui porte la génération courante
+        uint8_t parity;
+        // dernier morceau consulté par getCell()
+        uint8_t last;
+        // coin haut gauche de la fenêtre sur le plan
+        int32_t ox, oy;
+        uint32_t changed[TILES_Y];
+        uint16_t birth;
+        uint16_t survival;
+
+        uint8_t hash(int16_t cx, int16_t cy);
+        uint8_t find(int16_t cx, int16_t cy);
+        uint8_t obtain(int16_t cx, int16_t cy);
+        void release(uint8_t i);
+        void reset();
+        uint16_t* row(int32_t x, int32_t y, bool create);
+        void markChanged(int32_t x, int32_t xsup, int32_t y);
+        void extend(uint8_t i);
+        uint16_t applyRule(uint32_t a, uint32_t c, uint32_t b);
+        void compute(uint8_t i);
+
+    public:
+
+        static const uint8_t WIDTH  = W;
+        static const uint8_t HEIGHT = H;
+        static const uint8_t TILE   = 8;
+        // pour l'éditeur, la fenêtre est bordée : le curseur ne la quitte pas
+        typedef DeadBorder Topology;
+        typedef Moore Neighbourhood;
+
+        PlaneAutomaton();
+        bool setRule(const char* rulestring);
+        bool setTopology(uint8_t id);
+        uint8_t getCell(size_t x, size_t y);
+        uint32_t getChangedTiles(uint8_t ty);
+        uint8_t getChangedCells(uint8_t y, uint8_t tx);
+        void getBounds(uint8_t& x, uint8_t& y, uint8_t& xsup, uint8_t& ysup);
+        bool pan(int8_t dx, int8_t dy);
+        void spawn(size_t x, size_t y);
+        void kill(size_t x, size_t y);
+        void clear();
+        void randomize(Soup& soup);
+        void addPattern(const uint8_t* pattern, uint8_t x, uint8_t y);
+        void step();
+        void step(uint16_t n);
+        bool stepRows(uint8_t rows);
+        bool isPending();
+};
+
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+PlaneAutomaton<W,H,CHUNKS>::PlaneAutomaton() : parity(0), ox(0), oy(0) {
+    this->setRule(Rule::CONWAY);
+    this->clear();
+}
+
+// une règle B0 ferait naître une infinité de cellules
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+bool PlaneAutomaton<W,H,CHUNKS>::setRule(const char* rulestring) {
+    Rule rule;
+    if (!rule.parse(rulestring) || rule.getStates() > 2 || (rule.getBirth() & 1) || rule.isLarge() || !rule.isTotalistic() || rule.getNeighbourhood()) {
+        return false;
+    }
+    this->birth = rule.getBirth();
+    this->survival = rule.getSurvival();
+    return true;
+}
+
+// le plan n'a pas de bord : il n'y a pas d'autre topologie
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+bool PlaneAutomaton<W,H,CHUNKS>::setTopology(uint8_t id) {
+    return id == Topology::ID;
+}
+
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+uint8_t PlaneAutomaton<W,H,CHUNKS>::getCell(size_t x, size_t y) {
+    int32_t px,py;
+    int16_t cx,cy;
+    const Chunk* c;
+    if (!Topology::wrap(x, W) || !Topology::wrap(y, H)) {
+        return 0;
+    }
+    px = this->ox + (int32_t)x - 1;
+    py = this->oy + (int32_t)y - 1;
+    cx = px >> 4;
+    cy = py >> 4;
+    // la vue parcourt la fenêtre rangée par rangée : le morceau est
+    // souvent le même que lors de l'appel précédent
+    if (this->last == NONE || this->chunks[this->last].idle == NONE || this->chunks[this->last].cx != cx || this->chunks[this->last].cy != cy) {
+        this->last = this->find(cx, cy);
+        if (this->last == NONE) {
+            return 0;
+        }
+    }
+    c = this->chunks + this->last;
+    return (c->rows[this->parity][py & 15] >> (px & 15)) & 1;
+}
+
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+uint32_t PlaneAutomaton<W,H,CHUNKS>::getChangedTiles(uint8_t ty) {
+    return this->changed[ty];
+}
+
+// les changements ne sont suivis que par tuile : toutes les cellules
+// d'une tuile changée sont signalées
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+uint8_t PlaneAutomaton<W,H,CHUNKS>::getChangedCells(uint8_t y, uint8_t tx) {
+    return (this->changed[y / TILE] >> tx) & 1 ? 0xFF : 0;
+}
+
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+void PlaneAutomaton<W,H,CHUNKS>::getBounds(uint8_t& x, uint8_t& y, uint8_t& xsup, uint8_t& ysup) {
+    x = y = 0;
+    xsup = W;
+    ysup = H;
+}
+
+// déplace la fenêtre de (dx,dy) cellules : elle est à redessiner
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+bool PlaneAutomaton<W,H,CHUNKS>::pan(int8_t dx, int8_t dy) {
+    this->ox += dx;
+    this->oy += dy;
+    memset(this->changed, 0xFF, sizeof(this->changed));
+    return true;
+}
+
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+void PlaneAutomaton<W,H,CHUNKS>::spawn(size_t x, size_t y) {
+    int32_t px,py;
+    uint16_t* r;
+    if (!Topology::wrap(x, W) || !Topology::wrap(y, H)) {
+        return;
+    }
+    px = this->ox + (int32_t)x - 1;
+    py = this->oy + (int32_t)y - 1;
+    if ((r = this->row(px, py, true))) {
+        *r |= 1 << (px & 15);
+        this->markChanged(px, px+1, py);
+    }
+}
+
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+void PlaneAutomaton<W,H,CHUNKS>::kill(size_t x, size_t y) {
+    int32_t px,py;
+    uint16_t* r;
+    if (!Topology::wrap(x, W) || !Topology::wrap(y, H)) {
+        return;
+    }
+    px = this->ox + (int32_t)x - 1;
+    py = this->oy + (int32_t)y - 1;
+    if ((r = this->row(px, py, false))) {
+        *r &= ~(1 << (px & 15));
+        this->markChanged(px, px+1, py);
+    }
+}
+
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+void PlaneAutomaton<W,H,CHUNKS>::clear() {
+    this->reset();
+    memset(this->changed, 0xFF, sizeof(this->changed));
+}
+
+// la soupe remplit la fenêtre
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+void PlaneAutomaton<W,H,CHUNKS>::randomize(Soup& soup) {
+    uint32_t bits[H][(W + 31) / 32];
+    size_t x,y;
+    this->clear();
+    soup.fill(bits[0], W, H);
+    for (y=0; y<H; y++) {
+        for (x=0; x<W; x++) {
+            if ((bits[y][x / 32] >> (x % 32)) & 1) {
+                this->spawn(x+1, y+1);
+            }
+        }
+    }
+}
+
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+void PlaneAutomaton<W,H,CHUNKS>::addPattern(const uint8_t* pattern, uint8_t x, uint8_t y) {
+    uint8_t w = pattern[0];
+    uint8_t h = pattern[1];
+    uint8_t c;
+    size_t i,j;
+    for (i=0; i<h; i++) {
+        for (j=0; j<w; j++) {
+            c = pattern[2 + i*w + j];
+            if (c & 0xF0) { this->spawn(x+2*j, y+i); }
+            if (c & 0x0F) { this->spawn(x+2*j+1, y+i); }
+        }
+    }
+}
+
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+void PlaneAutomaton<W,H,CHUNKS>::step() {
+    uint8_t i;
+    memset(this->changed, 0, sizeof(this->changed));
+    // la frontière d'abord : les morceaux créés sont vides et n'ont
+    // eux-mêmes besoin d'aucun voisin
+    for (i=0; i<CHUNKS; i++) {
+        if (this->chunks[i].idle != NONE) {
+            this->extend(i);
+        }
+    }
+    for (i=0; i<CHUNKS; i++) {
+        if (this->chunks[i].idle != NONE) {
+            this->compute(i);
+        }
+    }
+    this->parity ^= 1;
+    for (i=0; i<CHUNKS; i++) {
+        if (this->chunks[i].idle != NONE && this->chunks[i].idle >= IDLE) {
+            this->release(i);
+        }
+    }
+}
+
+// n générations d'affilée ; la fenêtre ne montrera que la dernière, avec
+// toutes les tuiles qui ont changé depuis la première
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+void PlaneAutomaton<W,H,CHUNKS>::step(uint16_t n) {
+    uint32_t seen[TILES_Y];
+    uint8_t ty;
+    memset(seen, 0, sizeof(seen));
+    while (n--) {
+        this->step();
+        for (ty=0; ty<TILES_Y; ty++) {
+            seen[ty] |= this->changed[ty];
+        }
+    }
+    memcpy(this->changed, seen, sizeof(seen));
+}
+
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+uint8_t PlaneAutomaton<W,H,CHUNKS>::hash(int16_t cx, int16_t cy) {
+    return (uint16_t)(cx * 31 + cy) % BUCKETS;
+}
+
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+uint8_t PlaneAutomaton<W,H,CHUNKS>::find(int16_t cx, int16_t cy) {
+    uint8_t i;
+    for (i=this->buckets[this->hash(cx, cy)]; i != NONE; i=this->chunks[i].next) {
+        if (this->chunks[i].cx == cx && this->chunks[i].cy == cy) {
+            return i;
+        }
+    }
+    return NONE;
+}
+
+// morceau (cx,cy), pris vide dans la réserve s'il n'existe pas encore ;
+// NONE si la réserve est épuisée
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+uint8_t PlaneAutomaton<W,H,CHUNKS>::obtain(int16_t cx, int16_t cy) {
+    uint8_t i = this->find(cx, cy);
+    uint8_t h;
+    Chunk* c;
+    if (i != NONE || this->free == NONE) {
+        return i;
+    }
+    i = this->free;
+    c = this->chunks + i;
+    this->free = c->next;
+    h = this->hash(cx, cy);
+    c->cx = cx;
+    c->cy = cy;
+    c->idle = 0;
+    memset(c->rows, 0, sizeof(c->rows));
+    c->next = this->buckets[h];
+    this->buckets[h] = i;
+    return i;
+}
+
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+void PlaneAutomaton<W,H,CHUNKS>::release(uint8_t i) {
+    Chunk* c = this->chunks + i;
+    uint8_t* p = this->buckets + this->hash(c->cx, c->cy);
+    for (; *p != i; p=&this->chunks[*p].next);
+    *p = c->next;
+    c->idle = NONE;
+    c->next = this->free;
+    this->free = i;
+}
+
+// rend tous les morceaux à la réserve
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+void PlaneAutomaton<W,H,CHUNKS>::reset() {
+    uint8_t i;
+    memset(this->buckets, NONE, sizeof(this->buckets));
+    this->free = NONE;
+    for (i=CHUNKS; i>0; i--) {
+        this->chunks[i-1].idle = NONE;
+        this->chunks[i-1].next = this->free;
+        this->free = i-1;
+    }
+    this->last = NONE;
+}
+
+// rangée de la génération courante contenant la cellule (x,y) du plan
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+uint16_t* PlaneAutomaton<W,H,CHUNKS>::row(int32_t x, int32_t y, bool create) {
+    uint8_t i = create ? this->obtain(x >> 4, y >> 4) : this->find(x >> 4, y >> 4);
+    if (i == NONE) {
+        return NULL;
+    }
+    return this->chunks[i].rows[this->parity] + (y & 15);
+}
+
+// marque les tuiles de la fenêtre touchées par les cellules x à xsup-1
+// de la rangée y du plan
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+void PlaneAutomaton<W,H,CHUNKS>::markChanged(int32_t x, int32_t xsup, int32_t y) {
+    uint8_t tx;
+    x -= this->ox;
+    xsup -= this->ox;
+    y -= this->oy;
+    if (y < 0 || y >= H || xsup <= 0 || x >= W) {
+        return;
+    }
+    x = x > 0 ? x : 0;
+    xsup = xsup < W ? xsup : W;
+    for (tx=x / TILE; tx <= (xsup-1) / TILE; tx++) {
+        this->changed[y / TILE] |= 1UL << tx;
+    }
+}
+
+// crée les morceaux voisins que pourraient atteindre les cellules
+// vivantes du bord du morceau i
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+void PlaneAutomaton<W,H,CHUNKS>::extend(uint8_t i) {
+    const uint16_t* r = this->chunks[i].rows[this->parity];
+    int16_t cx = this->chunks[i].cx;
+    int16_t cy = this->chunks[i].cy;
+    uint16_t west = 0, east = 0;
+    uint8_t j;
+    for (j=0; j<CHUNK; j++) {
+        west |= r[j] & 1;
+        east |= r[j] >> 15;
+    }
+    if (r[0])              { this->obtain(cx, cy-1); }
+    if (r[CHUNK-1])        { this->obtain(cx, cy+1); }
+    if (west)              { this->obtain(cx-1, cy); }
+    if (east)              { this->obtain(cx+1, cy); }
+    if (r[0] & 1)          { this->obtain(cx-1, cy-1); }
+    if (r[0] >> 15)        { this->obtain(cx+1, cy-1); }
+    if (r[CHUNK-1] & 1)    { this->obtain(cx-1, cy+1); }
+    if (r[CHUNK-1] >> 15)  { this->obtain(cx+1, cy+1); }
+}
+
+// rangée suivante à partir des rangées a (au-dessus), c et b (au-dessous),
+// élargies d'une cellule de chaque côté : le bit i+1 porte la cellule i ;
+// les 8 voisins sont additionnés bit à bit sur 4 plans s0 à s3
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+uint16_t PlaneAutomaton<W,H,CHUNKS>::applyRule(uint32_t a, uint32_t c, uint32_t b) {
+    uint32_t v[8] = { a, a >> 1, a >> 2, c, c >> 2, b, b >> 1, b >> 2 };
+    uint32_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    uint32_t t,eq,alive = c >> 1;
+    uint16_t next = 0;
+    uint8_t k;
+    for (k=0; k<8; k++) {
+        t = s0 & v[k];
+        s0 ^= v[k];
+        s3 |= s2 & s1 & t;
+        s2 ^= s1 & t;
+        s1 ^= t;
+    }
+    for (k=0; k<9; k++) {
+        eq = (k & 1 ? s0 : ~s0) & (k & 2 ? s1 : ~s1) & (k & 4 ? s2 : ~s2) & (k & 8 ? s3 : ~s3);
+        if ((this->birth >> k) & 1)    { next |= eq & ~alive; }
+        if ((this->survival >> k) & 1) { next |= eq & alive; }
+    }
+    return next;
+}
+
+// calcule la génération suivante du morceau i dans son second tampon
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+void PlaneAutomaton<W,H,CHUNKS>::compute(uint8_t i) {
+    static const uint16_t EMPTY[CHUNK] = {0};
+    Chunk* c = this->chunks + i;
+    const uint16_t* around[3][3];
+    uint32_t ext[CHUNK+2];
+    uint16_t* next = c->rows[this->parity ^ 1];
+    const uint16_t* w;
+    const uint16_t* m;
+    const uint16_t* e;
+    uint16_t d,any = 0;
+    uint8_t j,k,l,n;
+    int32_t x;
+
+    for (k=0; k<3; k++) {
+        for (l=0; l<3; l++) {
+            n = this->find(c->cx + l - 1, c->cy + k - 1);
+            around[k][l] = n == NONE ? EMPTY : this->chunks[n].rows[this->parity];
+        }
+    }
+    // rangées -1 à 16 du morceau, élargies des colonnes voisines
+    for (j=0; j<CHUNK+2; j++) {
+        k = j == 0 ? 0 : j == CHUNK+1 ? 2 : 1;
+        l = j == 0 ? CHUNK-1 : j == CHUNK+1 ? 0 : j-1;
+        w = around[k][0];
+        m = around[k][1];
+        e = around[k][2];
+        ext[j] = (w[l] >> 15) | ((uint32_t)m[l] << 1) | ((uint32_t)(e[l] & 1) << 17);
+    }
+    for (j=0; j<CHUNK; j++) {
+        next[j] = this->applyRule(ext[j], ext[j+1], ext[j+2]);
+        any |= next[j];
+        d = next[j] ^ c->rows[this->parity][j];
+        if (d) {
+            x = (int32_t)c->cx * CHUNK;
+            this->markChanged(x + __builtin_ctz(d), x + 32 - __builtin_clz(d), (int32_t)c->cy * CHUNK + j);
+        }
+    }
+    c->idle = any ? 0 : c->idle + 1;
+}
+
+// les morceaux sont tous avancés ensemble, d'un seul bloc
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+bool PlaneAutomaton<W,H,CHUNKS>::stepRows(uint8_t) {
+    this->step();
+    return true;
+}
+
+template <uint8_t W, uint8_t H, uint8_t CHUNKS>
+bool PlaneAutomaton<W,H,CHUNKS>::isPending() {
+    return false;
+}
+
+#endif
@@ -0,0 +1,304 @@
+#include "Rule.h"
+
+const char* Rule::CONWAY = "B3/S23";
+
+// l'état d'une cellule doit tenir sur un quartet
+const uint8_t Rule::MAX_STATES = 16;
+
+// lettres de Hensel valables après les chiffres 0 à 4 : au-delà de 4, la
+// lettre désigne le complément de la forme de même lettre pour 8-n voisins
+const char* Rule::LETTERS[] = {"", "ce", "ceaikn", "ceaiknjqry", "ceaiknjqrytwz"};
+
+// une forme par lettre, dans l'ordre de LETTERS : le bit 3*rangée + colonne
+// indique une case vivante du voisinage 3x3, dont le centre est le bit 4
+const uint16_t Rule::SHAPES[][13] = {
+    {},
+    {1, 2},
+    {5, 10, 3, 40, 33, 68},
+    {69, 42, 11, 7, 98, 13, 14, 70, 41, 97},
+    {325, 170, 15, 45, 99, 71, 106, 102, 43, 101, 105, 78, 108}
+};
+
+Rule::Rule() : states(2) {
+    this->setMasks(1 << 3, (1 << 2) | (1 << 3), NULL);
+}
+
+// analyse une règle de la forme B36/S23, de la forme 345/2/4 pour
+// la famille Generations (survie/naissance/nombre d'états), ou de la
+// forme R5,C0,M1,S34..58,B34..45,NM pour Larger than Life : la règle
+// courante n'est modifiée que si la chaîne est valide
+bool Rule::parse(const char* rulestring) {
+    if (*rulestring == 'B' || *rulestring == 'b') {
+        return this->parseLife(rulestring);
+    }
+    if (*rulestring == 'R') {
+        return this->parseLarger(rulestring);
+    }
+    return this->parseGenerations(rulestring);
+}
+
+// un chiffre seul ajoute son bit au masque ; suivi de lettres, il n'ajoute
+// à extra que les configurations qu'elles désignent (center vaut 0x10 pour
+// la survie : la cellule est alors vivante)
+const char* Rule::parseDigits(const char* c, uint16_t* mask, uint8_t* extra, uint16_t center) {
+    const char* next;
+    uint8_t n;
+    while (*c >= '0' && *c <= '8') {
+        n = *c++ - '0';
+        next = this->parseLetters(c, n, extra, center);
+        if (next == c) {
+            *mask |= 1 << n;
+        }
+        c = next;
+    }
+    return c;
+}
+
+// lettres qui suivent le chiffre n, précédées de « - » pour retenir toutes
+// les formes sauf celles-là : renvoie c si aucune lettre ne suit
+const char* Rule::parseLetters(const char* c, uint8_t n, uint8_t* extra, uint16_t center) {
+    uint8_t m = n <= 4 ? n : 8-n;
+    const char* letters = LETTERS[m];
+    const char* p = *c == '-' ? c+1 : c;
+    const char* l;
+    uint16_t chosen = 0;
+    uint16_t shape;
+    uint8_t k;
+    for (; *p && (l = strchr(letters, *p)); p++) {
+        chosen |= 1 << (l - letters);
+    }
+    if (!chosen) {
+        return c;
+    }
+    if (*c == '-') {
+        chosen = ~chosen;
+    }
+    for (k=0; letters[k]; k++) {
+        if ((chosen >> k) & 1) {
+            shape = n <= 4 ? SHAPES[m][k] : 0x1EF & ~SHAPES[m][k];
+            this->mark(extra, shape | center);
+        }
+    }
+    return p;
+}
+
+// ajoute à extra la configuration shape et ses 7 images par rotation d'un
+// quart de tour, (x,y) devenant (2-y,x), ou par symétrie ; la numérotation
+// des cases des moteurs s'en déduit ainsi, et désigne les mêmes formes
+void Rule::mark(uint8_t* extra, uint16_t shape) {
+    uint16_t image,mirror;
+    uint8_t r,k;
+    for (r=0; r<4; r++) {
+        image = mirror = 0;
+        for (k=0; k<9; k++) {
+            if ((shape >> k) & 1) {
+                image |= 1 << ((k % 3)*3 + 2 - k/3);
+                mirror |= 1 << (k - 2*(k % 3) + 2);
+            }
+        }
+        extra[shape >> 3] |= 1 << (shape & 7);
+        extra[mirror >> 3] |= 1 << (mirror & 7);
+        shape = image;
+    }
+}
+
+// lit un entier décimal : renvoie NULL s'il n'y a aucun chiffre
+const char* Rule::parseNumber(const char* c, uint16_t* n) {
+    const char* start = c;
+    for (*n = 0; *c >= '0' && *c <= '9' && *n < 1000; c++) {
+        *n = 10 * *n + *c - '0';
+    }
+    return c == start ? NULL : c;
+}
+
+bool Rule::parseLife(const char* rulestring) {
+    uint16_t b = 0;
+    uint16_t s = 0;
+    uint8_t extra[64];
+    const char* c;
+    char id;
+
+    memset(extra, 0, sizeof(extra));
+    c = this->parseDigits(rulestring+1, &b, extra, 0);
+    if (c[0] != '/' || (c[1] != 'S' && c[1] != 's')) {
+        return false;
+    }
+    c = this->parseDigits(c+2, &s, extra, 0x10);
+    c = this->parseNeighbourhood(c, &id);
+    if (*c) {
+        return false;
+    }
+
+    this->setMasks(b, s, extra);
+    this->neighbourhood = id;
+    this->states = 2;
+    return true;
+}
+
+bool Rule::parseGenerations(const char* rulestring) {
+    uint16_t b = 0;
+    uint16_t s = 0;
+    uint8_t n = 0;
+    uint8_t extra[64];
+    const char* c;
+    char id;
+
+    memset(extra, 0, sizeof(extra));
+    c = this->parseDigits(rulestring, &s, extra, 0x10);
+    if (*c++ != '/') {
+        return false;
+    }
+    c = this->parseDigits(c, &b, extra, 0);
+    if (*c++ != '/') {
+        return false;
+    }
+    for (; *c >= '0' && *c <= '9' && n <= MAX_STATES; c++) {
+        n = 10*n + *c - '0';
+    }
+    c = this->parseNeighbourhood(c, &id);
+    if (*c || n < 2 || n > MAX_STATES) {
+        return false;
+    }
+
+    this->setMasks(b, s, extra);
+    this->neighbourhood = id;
+    this->states = n;
+    return true;
+}
+
+// suffixe facultatif du voisinage, qui termine la règle
+const char* Rule::parseNeighbourhood(const char* c, char* id) {
+    *id = *c == 'V' || *c == 'H' ? *c : 0;
+    return *id ? c+1 : c;
+}
+
+// Rr,Cc,Mm,Smin..max,Bmin..max,Nx (notation de Golly) : r est le rayon,
+// c le nombre d'états (0 ou 1 valent 2), m vaut 1 si la cellule compte
+// parmi ses propres voisins, et x vaut M (Moore) ou N (von Neumann)
+bool Rule::parseLarger(const char* rulestring) {
+    uint16_t r,n,m,smin,smax,bmin,bmax;
+    uint16_t b = 0;
+    uint16_t s = 0;
+    uint8_t k;
+    bool diamond = false;
+    const char* c = this->parseNumber(rulestring+1, &r);
+
+    if (!c || c[0] != ',' || c[1] != 'C' || !(c = this->parseNumber(c+2, &n))) { return false; }
+    if (c[0] != ',' || c[1] != 'M' || !(c = this->parseNumber(c+2, &m))) { return false; }
+    if (c[0] != ',' || c[1] != 'S' || !(c = this->parseNumber(c+2, &smin))) { return false; }
+    if (c[0] != '.' || c[1] != '.' || !(c = this->parseNumber(c+2, &smax))) { return false; }
+    if (c[0] != ',' || c[1] != 'B' || !(c = this->parseNumber(c+2, &bmin))) { return false; }
+    if (c[0] != '.' || c[1] != '.' || !(c = this->parseNumber(c+2, &bmax))) { return false; }
+    if (c[0] == ',' && c[1] == 'N' && (c[2] == 'M' || c[2] == 'N')) {
+        diamond = c[2] == 'N';
+        c += 3;
+    }
+    if (*c || r < 1 || r > MAX_RADIUS || n > MAX_STATES || m > 1 || smax > 255 || bmax > 255) {
+        return false;
+    }
+
+    // la cellule vivante est retirée du compte pour la survie (une
+    // cellule morte n'y ajoute rien) : avec S0..0, nulle ne survit
+    if (m && smax == 0) {
+        smin = 1;
+    } else if (m) {
+        smin = smin ? smin-1 : 0;
+        smax--;
+    }
+    for (k=0; k<16; k++) {
+        if (k >= bmin && k <= bmax) { b |= 1 << k; }
+        if (k >= smin && k <= smax) { s |= 1 << k; }
+    }
+
+    this->setMasks(b, s, NULL);
+    this->states = n < 2 ? 2 : n;
+    this->radius = r;
+    this->vonNeumann = diamond;
+    this->birthMin = bmin;
+    this->birthMax = bmax;
+    this->survivalMin = smin;
+    this->survivalMax = smax;
+    return true;
+}
+
+// conditions données bit à bit, pour le voisinage 3x3, complétées par
+// les configurations de extra s'il y en a ; l'index d'une configuration
+// range les colonnes de gauche à droite, chacune codée sur 3 bits (haut,
+// centre, bas) : la cellule est le bit 4
+void Rule::setMasks(uint16_t birth, uint16_t survival, const uint8_t* extra) {
+    uint16_t i,k;
+    uint8_t n;
+    bool alive,chosen;
+    this->birth = birth;
+    this->survival = survival;
+    this->radius = 1;
+    this->vonNeumann = false;
+    this->totalistic = true;
+    this->neighbourhood = 0;
+    memset(this->table, 0, sizeof(this->table));
+    for (i=0; i<512; i++) {
+        n = 0;
+        for (k=i & ~0x10; k; k >>= 1) {
+            n += k & 1;
+        }
+        alive = i & 0x10 ? survival & (1 << n) : birth & (1 << n);
+        chosen = extra && ((extra[i >> 3] >> (i & 7)) & 1);
+        if (alive || chosen) {
+            this->table[i >> 3] |= 1 << (i & 7);
+        }
+        if (chosen && !alive) {
+            this->totalistic = false;
+        }
+    }
+}
+
+uint16_t Rule::getBirth() {
+    return this->birth;
+}
+
+uint16_t Rule::getSurvival() {
+    return this->survival;
+}
+
+uint8_t Rule::getStates() {
+    return this->states;
+}
+
+uint8_t Rule::getRadius() {
+    return this->radius;
+}
+
+bool Rule::isVonNeumann() {
+    return this->vonNeumann;
+}
+
+bool Rule::isTotalistic() {
+    return this->totalistic;
+}
+
+const uint8_t* Rule::getTable() {
+    return this->table;
+}
+
+char Rule::getNeighbourhood() {
+    return this->neighbourhood;
+}
+
+// la règle ne se ramène pas à une table sur le voisinage 3x3
+bool Rule::isLarge() {
+    return this->radius > 1 || this->vonNeumann;
+}
+
+void Rule::getBirthRange(uint8_t& min, uint8_t& max) {
+    min = this->birthMin;
+    max = this->birthMax;
+}
+
+void Rule::getSurvivalRange(uint8_t& min, uint8_t& max) {
+    min = this->survivalMin;
+    max = this->survivalMax;
+}
+
+bool Rule::isConway() {
+    return this->birth == (1 << 3) && this->survival == ((1 << 2) | (1 << 3)) && this->states == 2 && this->totalistic && !this->neighbourhood && !this->isLarge();
+}
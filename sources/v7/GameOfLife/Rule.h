@@ -0,0 +1,76 @@
+#ifndef GAME_OF_LIFE_RULE_H_
+#define GAME_OF_LIFE_RULE_H_
+
+#include "bootstrap.h"
+
+// Règle d'un automate « Life-like » : le bit n de birth (resp. survival)
+// indique qu'une cellule naît (resp. survit) avec n voisins. Les règles
+// de la famille Generations ajoutent des états de déclin : une cellule
+// qui ne survit pas passe par les états 2 à states-1 avant de mourir.
+// Les règles « Larger than Life » comptent les voisins jusqu'à une
+// distance radius, dans un carré (Moore) ou un losange (von Neumann) :
+// le nombre de voisins peut dépasser 15, et les conditions de naissance
+// et de survie sont alors des intervalles.
+// Un chiffre peut enfin être suivi de lettres (notation de Hensel, par
+// exemple B2-a/S12) qui restreignent la condition à certaines formes du
+// voisinage, à une symétrie près : la règle est dite non totalistique, et
+// n'est plus décrite que par sa table sur les 512 configurations 3x3.
+// Un suffixe V ou H (B2/S013V, B2/S34H) réserve enfin la règle au
+// voisinage de von Neumann ou à la grille hexagonale (Neighbourhood.h).
+class Rule
+{
+    private:
+
+        uint16_t birth;
+        uint16_t survival;
+        uint8_t states;
+        uint8_t radius;
+        bool vonNeumann;
+        bool totalistic;
+        // suffixe du voisinage 3x3 (0 pour Moore, 'V' ou 'H')
+        char neighbourhood;
+        // table de transition : le bit i indique si la cellule est vivante
+        // à la génération suivante dans la configuration i du voisinage 3x3
+        uint8_t table[64];
+        // intervalles [min,max] du nombre de voisins, la cellule exclue
+        uint8_t birthMin, birthMax;
+        uint8_t survivalMin, survivalMax;
+
+        static const char* LETTERS[];
+        static const uint16_t SHAPES[][13];
+
+        const char* parseDigits(const char* c, uint16_t* mask, uint8_t* extra, uint16_t center);
+        const char* parseLetters(const char* c, uint8_t n, uint8_t* extra, uint16_t center);
+        void mark(uint8_t* extra, uint16_t shape);
+        const char* parseNeighbourhood(const char* c, char* id);
+        const char* parseNumber(const char* c, uint16_t* n);
+        bool parseLife(const char* rulestring);
+        bool parseGenerations(const char* rulestring);
+        bool parseLarger(const char* rulestring);
+        void setMasks(uint16_t birth, uint16_t survival, const uint8_t* extra);
+
+    public:
+
+        static const char* CONWAY;
+        static const uint8_t MAX_STATES;
+        // rayon maximal du voisinage, connu à la compilation pour
+        // dimensionner les tampons des moteurs
+        static const uint8_t MAX_RADIUS = 7;
+
+        Rule();
+        bool parse(const char* rulestring);
+        uint16_t getBirth();
+        uint16_t getSurvival();
+        uint8_t getStates();
+        uint8_t getRadius();
+        bool isVonNeumann();
+        bool isLarge();
+        bool isTotalistic();
+        const uint8_t* getTable();
+        char getNeighbourhood();
+        void getBirthRange(uint8_t& min, uint8_t& max);
+        void getSurvivalRange(uint8_t& min, uint8_t& max);
+        bool isConway();
+};
+
+#endif
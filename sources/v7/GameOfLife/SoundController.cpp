@@ -22,4 +22,8 @@ void SoundController::playStep() {
 
 void SoundController::playStopEdit() {
     gb.sound.playOK();
+}
+
+void SoundController::playError() {
+    gb.sound.playCancel();
 }
\ No newline at end of file
@@ -17,6 +17,7 @@ class SoundController
         void playStop();
         void playStep();
         void playStopEdit();
+        void playError();
 };
 
 #endif
\ No newline at end of file
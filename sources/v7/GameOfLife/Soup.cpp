@@ -0,0 +1,119 @@
+#include "Soup.h"
+
+// une graine nulle bloquerait le générateur sur 0
+Soup::Soup(uint32_t seed, uint8_t density, uint8_t symmetry) : state(seed ? seed : 0x9E3779B9), pool(0), left(0), density(density), symmetry(symmetry) {
+
+}
+
+uint32_t Soup::next() {
+    uint32_t x = this->state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    this->state = x;
+    return x;
+}
+
+// chaque bit vaut 1 avec une probabilité de density/256 : on combine un
+// mot tiré par bit de density, du poids faible au poids fort, par un OU
+// pour un 1 et par un ET pour un 0 ; les 0 de poids faible, qui laissent
+// le mot nul, sont sautés
+uint32_t Soup::word() {
+    uint32_t w = 0;
+    uint8_t k = 0;
+    if (!this->density) {
+        return 0;
+    }
+    for (; !((this->density >> k) & 1); k++);
+    for (; k<8; k++) {
+        w = (this->density >> k) & 1 ? w | this->next() : w & this->next();
+    }
+    return w;
+}
+
+// les cellules tirées une à une puisent dans un mot de réserve
+bool Soup::bit() {
+    bool b;
+    if (!this->left) {
+        this->pool = this->word();
+        this->left = 32;
+    }
+    b = this->pool & 1;
+    this->pool >>= 1;
+    this->left--;
+    return b;
+}
+
+// âge de départ d'une cellule vivante, de 1 à 3
+uint8_t Soup::age() {
+    return 1 + this->next() % 3;
+}
+
+// remplit l'image bits de w x h cellules
+void Soup::fill(uint32_t* bits, uint8_t w, uint8_t h) {
+    uint8_t words = (w + 31) / 32;
+    uint8_t s = w < h ? w : h;
+    uint8_t ox = 0, oy = 0, rw = w, rh = h;
+    uint8_t x,y,mx,my,k,n;
+    // les autres cellules de l'orbite de (x,y)
+    uint8_t ux[3], uy[3];
+    uint32_t* r;
+    bool alive;
+
+    memset(bits, 0, words * h * sizeof(uint32_t));
+    if (this->symmetry == NONE) {
+        for (y=0, r=bits; y<h; y++, r+=words) {
+            for (k=0; k<words; k++) {
+                r[k] = this->word();
+            }
+            if (w % 32) {
+                r[words-1] &= (1UL << (w % 32)) - 1;
+            }
+        }
+        return;
+    }
+
+    // le quart de tour n'a de sens que sur un carré
+    if (this->symmetry == C4) {
+        rw = rh = s;
+        ox = (w - s) / 2;
+        oy = (h - s) / 2;
+    }
+    for (y=0; y<rh; y++) {
+        for (x=0; x<rw; x++) {
+            if (this->symmetry == C2) {
+                ux[0] = rw-1 - x; uy[0] = rh-1 - y;
+                n = 1;
+            } else if (this->symmetry == C4) {
+                ux[0] = rw-1 - y; uy[0] = x;
+                ux[1] = rw-1 - x; uy[1] = rh-1 - y;
+                ux[2] = y;        uy[2] = rw-1 - x;
+                n = 3;
+            } else {
+                ux[0] = rw-1 - x; uy[0] = y;
+                ux[1] = x;        uy[1] = rh-1 - y;
+                ux[2] = rw-1 - x; uy[2] = rh-1 - y;
+                n = 3;
+            }
+            // la première cellule de l'orbite a déjà été remplie, à moins
+            // que ce ne soit (x,y) elle-même
+            mx = x;
+            my = y;
+            for (k=0; k<n; k++) {
+                if (uy[k] < my || (uy[k] == my && ux[k] < mx)) {
+                    mx = ux[k];
+                    my = uy[k];
+                }
+            }
+            if (mx == x && my == y) {
+                alive = this->bit();
+            } else {
+                r = bits + (oy + my) * words;
+                alive = (r[(ox + mx) / 32] >> ((ox + mx) % 32)) & 1;
+            }
+            if (alive) {
+                bits[(oy + y) * words + (ox + x) / 32] |= 1UL << ((ox + x) % 32);
+            }
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef GAME_OF_LIFE_SOUP_H_
+#define GAME_OF_LIFE_SOUP_H_
+
+#include "bootstrap.h"
+
+// Soupe aléatoire reproductible : un générateur xorshift32, dont la graine
+// fixe toute la soupe, quelle que soit la machine, remplit une image de
+// 1 bit par cellule (rangée par rangée, la cellule x étant le bit x % 32
+// du mot x / 32) 32 cellules à la fois. Une cellule est vivante avec une
+// probabilité de density/256. Avec une symétrie, seule la première cellule
+// de chaque orbite (dans l'ordre des rangées) est tirée, les autres en
+// sont la copie : C2 (demi-tour), C4 (quart de tour, sur le plus grand
+// carré centré) ou D4 (miroirs horizontal et vertical). Les âges des
+// cellules vivantes, entre 1 et 3, sont tirés à la suite de l'image.
+class Soup
+{
+    private:
+
+        uint32_t state;
+        uint32_t pool;
+        uint8_t left;
+        uint8_t density;
+        uint8_t symmetry;
+
+        uint32_t next();
+        uint32_t word();
+        bool bit();
+
+    public:
+
+        // une cellule sur deux par défaut ; ces constantes servent à
+        // initialiser les tables des menus, et sont donc connues ici
+        static const uint8_t DENSITY = 128;
+        static const uint8_t NONE = 0;
+        static const uint8_t C2   = 1;
+        static const uint8_t C4   = 2;
+        static const uint8_t D4   = 3;
+
+        Soup(uint32_t seed, uint8_t density, uint8_t symmetry);
+        void fill(uint32_t* bits, uint8_t w, uint8_t h);
+        uint8_t age();
+};
+
+#endif
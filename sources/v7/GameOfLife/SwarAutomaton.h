@@ -0,0 +1,377 @@
+#ifndef GAME_OF_LIFE_SWAR_AUTOMATON_H_
+#define GAME_OF_LIFE_SWAR_AUTOMATON_H_
+
+#include "bootstrap.h"
+#include "Boundary.h"
+#include "Neighbourhood.h"
+#include "Rule.h"
+#include "Soup.h"
+
+// Moteur alternatif à Automaton : chaque cellule n'occupe plus qu'un bit
+// et la génération suivante est calculée 32 cellules à la fois. L'âge se
+// réduit à un second plan de bits, qui distingue les cellules nées à la
+// dernière génération (âge 1) des plus anciennes (âge 2) : les couleurs
+// des motifs et des cellules créées à l'édition sont donc perdues.
+template <uint8_t W, uint8_t H, class Boundary>
+class SwarAutomaton
+{
+    private:
+
+        static const uint8_t WORDS = (W + 31) / 32;
+        static const uint32_t LAST_MASK = W % 32 ? (1UL << (W % 32)) - 1 : 0xFFFFFFFF;
+        static const uint8_t TILES_Y = (H + 7) / 8;
+
+        // liveness des cellules, 1 bit par cellule, rangée par rangée
+        uint32_t cells[H][WORDS];
+        // cellules nées à la dernière génération
+        uint32_t young[H][WORDS];
+        // tuiles de 8x8 cellules modifiées lors de la dernière génération
+        uint32_t changed[TILES_Y];
+
+        uint16_t birth;
+        uint16_t survival;
+        bool conway;
+
+        void shiftWest(const uint32_t* row, uint32_t* out);
+        void shiftEast(const uint32_t* row, uint32_t* out);
+        void setAge(size_t x, size_t y, uint8_t a);
+        void updateAge(size_t y, uint32_t* alive);
+        uint32_t applyRule(uint32_t alive, uint32_t s0, uint32_t s1, uint32_t s2, uint32_t s3);
+
+    public:
+
+        static const uint8_t WIDTH  = W;
+        static const uint8_t HEIGHT = H;
+        static const uint8_t TILE   = 8;
+        typedef Boundary Topology;
+        typedef Moore Neighbourhood;
+
+        SwarAutomaton();
+        bool setRule(const char* rulestring);
+        bool setTopology(uint8_t id);
+        uint8_t getCell(size_t x, size_t y);
+        uint32_t getChangedTiles(uint8_t ty);
+        uint8_t getChangedCells(uint8_t y, uint8_t tx);
+        void getBounds(uint8_t& x, uint8_t& y, uint8_t& xsup, uint8_t& ysup);
+        bool pan(int8_t dx, int8_t dy);
+        void spawn(size_t x, size_t y);
+        void kill(size_t x, size_t y);
+        void clear();
+        void randomize(Soup& soup);
+        void addPattern(const uint8_t* pattern, uint8_t x, uint8_t y);
+        void step();
+        void step(uint16_t n);
+        bool stepRows(uint8_t rows);
+        bool isPending();
+};
+template <uint8_t W, uint8_t H, class Boundary>
+SwarAutomaton<W,H,Boundary>::SwarAutomaton() {
+    this->setRule(Rule::CONWAY);
+    this->clear();
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+bool SwarAutomaton<W,H,Boundary>::setRule(const char* rulestring) {
+    Rule rule;
+    // un bit par cellule ne suffit pas aux états de déclin des règles Generations
+    if (!rule.parse(rulestring) || rule.getStates() > 2 || rule.isLarge() || !rule.isTotalistic() || rule.getNeighbourhood()) {
+        return false;
+    }
+    this->birth = rule.getBirth();
+    this->survival = rule.getSurvival();
+    this->conway = rule.isConway();
+    return true;
+}
+
+// la topologie est fixée à la compilation
+template <uint8_t W, uint8_t H, class Boundary>
+bool SwarAutomaton<W,H,Boundary>::setTopology(uint8_t id) {
+    return id == Boundary::ID;
+}
+
+// les coordonnées suivent la convention d'Automaton : la partie visible
+// de la grille est comprise entre (1,1) et (W,H)
+template <uint8_t W, uint8_t H, class Boundary>
+uint8_t SwarAutomaton<W,H,Boundary>::getCell(size_t x, size_t y) {
+    if (!Boundary::wrap(x, W) || !Boundary::wrap(y, H)) {
+        return 0;
+    }
+    size_t i = x-1;
+    size_t j = y-1;
+    size_t k = i >> 5;
+    uint32_t b = 1UL << (i & 31);
+    if (!(this->cells[j][k] & b)) {
+        return 0;
+    }
+    return this->young[j][k] & b ? 1 : 2;
+}
+
+// tuiles de la ligne de tuiles ty dont au moins une cellule
+// a changé d'état lors de la dernière génération
+template <uint8_t W, uint8_t H, class Boundary>
+uint32_t SwarAutomaton<W,H,Boundary>::getChangedTiles(uint8_t ty) {
+    return this->changed[ty];
+}
+
+// changed ne retient que les tuiles : toute la rangée de la tuile
+// est signalée
+template <uint8_t W, uint8_t H, class Boundary>
+uint8_t SwarAutomaton<W,H,Boundary>::getChangedCells(uint8_t y, uint8_t tx) {
+    return (this->changed[y / TILE] >> tx) & 1 ? 0xFF : 0;
+}
+
+// le rectangle englobant n'est pas suivi ici : c'est toute la grille
+template <uint8_t W, uint8_t H, class Boundary>
+void SwarAutomaton<W,H,Boundary>::getBounds(uint8_t& x, uint8_t& y, uint8_t& xsup, uint8_t& ysup) {
+    x = y = 0;
+    xsup = W;
+    ysup = H;
+}
+
+// toute la grille est affichée : pan() n'a aucun effet
+template <uint8_t W, uint8_t H, class Boundary>
+bool SwarAutomaton<W,H,Boundary>::pan(int8_t dx, int8_t dy) {
+    return false;
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+void SwarAutomaton<W,H,Boundary>::spawn(size_t x, size_t y) {
+    this->setAge(x, y, 13);
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+void SwarAutomaton<W,H,Boundary>::kill(size_t x, size_t y) {
+    this->setAge(x, y, 0);
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+void SwarAutomaton<W,H,Boundary>::clear() {
+    memset(this->cells, 0, sizeof(this->cells));
+    memset(this->young, 0, sizeof(this->young));
+    memset(this->changed, 0xFF, sizeof(this->changed));
+}
+
+// la soupe est tirée directement dans le plan des cellules vivantes ;
+// les âges sont tirés dans le même ordre que pour Automaton, seul l'âge 1
+// étant retenu
+template <uint8_t W, uint8_t H, class Boundary>
+void SwarAutomaton<W,H,Boundary>::randomize(Soup& soup) {
+    uint32_t b;
+    size_t y,k;
+    soup.fill(this->cells[0], W, H);
+    memset(this->young, 0, sizeof(this->young));
+    for (y=0; y<H; y++) {
+        for (k=0; k<WORDS; k++) {
+            for (b=1; b; b<<=1) {
+                if ((this->cells[y][k] & b) && soup.age() == 1) {
+                    this->young[y][k] |= b;
+                }
+            }
+        }
+    }
+    memset(this->changed, 0xFF, sizeof(this->changed));
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+void SwarAutomaton<W,H,Boundary>::addPattern(const uint8_t* pattern, uint8_t x, uint8_t y) {
+    uint8_t w = pattern[0];
+    uint8_t h = pattern[1];
+    uint8_t c,l,r;
+    size_t i,j;
+    for (i=0; i<h; i++) {
+        for (j=0; j<w; j++) {
+            c = pattern[2 + i*w + j];
+            l = (c & 0xF0) >> 4;
+            r = c & 0xF;
+            if (l) { this->setAge(x+2*j, y+i, l); }
+            if (r) { this->setAge(x+2*j+1, y+i, r); }
+        }
+    }
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+void SwarAutomaton<W,H,Boundary>::setAge(size_t x, size_t y, uint8_t a) {
+    if (!Boundary::wrap(x, W) || !Boundary::wrap(y, H)) {
+        return;
+    }
+    size_t i = x-1;
+    size_t j = y-1;
+    size_t k = i >> 5;
+    uint32_t b = 1UL << (i & 31);
+    if (a == 1) {
+        this->young[j][k] |= b;
+    } else {
+        this->young[j][k] &= ~b;
+    }
+    if (a) {
+        this->cells[j][k] |= b;
+    } else {
+        this->cells[j][k] &= ~b;
+    }
+    this->changed[j / TILE] |= 1UL << (i / TILE);
+}
+
+// décale la rangée d'une cellule vers l'est : le bit x reçoit la cellule x-1,
+// et le bit 0 la dernière cellule de la rangée sur un tore
+template <uint8_t W, uint8_t H, class Boundary>
+void SwarAutomaton<W,H,Boundary>::shiftWest(const uint32_t* row, uint32_t* out) {
+    uint8_t i;
+    out[0] = row[0] << 1;
+    if (!Boundary::DEAD) {
+        out[0] |= (row[(W-1) >> 5] >> ((W-1) & 31)) & 1;
+    }
+    for (i=1; i<WORDS; i++) {
+        out[i] = (row[i] << 1) | (row[i-1] >> 31);
+    }
+    out[WORDS-1] &= LAST_MASK;
+}
+
+// décale la rangée d'une cellule vers l'ouest : le bit x reçoit la cellule x+1,
+// et le bit W-1 la première cellule de la rangée sur un tore
+template <uint8_t W, uint8_t H, class Boundary>
+void SwarAutomaton<W,H,Boundary>::shiftEast(const uint32_t* row, uint32_t* out) {
+    uint8_t i;
+    for (i=0; i<WORDS-1; i++) {
+        out[i] = (row[i] >> 1) | (row[i+1] << 31);
+    }
+    out[WORDS-1] = row[WORDS-1] >> 1;
+    if (!Boundary::DEAD) {
+        out[WORDS-1] |= (row[0] & 1) << ((W-1) & 31);
+    }
+}
+
+// une cellule change d'aspect si elle naît, meurt, ou survit à
+// sa première génération
+template <uint8_t W, uint8_t H, class Boundary>
+void SwarAutomaton<W,H,Boundary>::updateAge(size_t y, uint32_t* alive) {
+    uint32_t o,n,born,t;
+    uint8_t i,p;
+    for (i=0; i<WORDS; i++) {
+        o = alive[i];
+        n = this->cells[y][i];
+        born = n & ~o;
+        t = born | (o & ~n) | (n & o & this->young[y][i]);
+        this->young[y][i] = born;
+        // chaque octet du mot couvre la rangée d'une tuile
+        for (p=4*i; t; t >>= 8, p++) {
+            if (t & 0xFF) {
+                this->changed[y / TILE] |= 1UL << p;
+            }
+        }
+    }
+}
+
+// règle quelconque : on teste, 32 cellules à la fois, l'égalité du
+// compteur (s3 s2 s1 s0) avec chaque nombre de voisins de la règle
+template <uint8_t W, uint8_t H, class Boundary>
+uint32_t SwarAutomaton<W,H,Boundary>::applyRule(uint32_t alive, uint32_t s0, uint32_t s1, uint32_t s2, uint32_t s3) {
+    uint32_t next = 0;
+    uint32_t eq,m;
+    uint8_t n;
+    for (n=0; n<9; n++) {
+        m = 0;
+        if (this->birth & (1 << n))    { m |= ~alive; }
+        if (this->survival & (1 << n)) { m |= alive; }
+        if (m) {
+            eq  = n & 1 ? s0 : ~s0;
+            eq &= n & 2 ? s1 : ~s1;
+            eq &= n & 4 ? s2 : ~s2;
+            eq &= n & 8 ? s3 : ~s3;
+            next |= eq & m;
+        }
+    }
+    return next;
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+void SwarAutomaton<W,H,Boundary>::step() {
+    uint32_t first[WORDS], above[WORDS], row[WORDS];
+    uint32_t aw[WORDS], ae[WORDS], rw[WORDS], re[WORDS], bw[WORDS], be[WORDS];
+    const uint32_t* below;
+    uint32_t s0,s1,s2,s3,sa,ca,sb,cb,sc,cc,cd,t,ce,cf;
+    size_t y;
+    uint8_t i;
+
+    // la grille est mise à jour sur place : il suffit de conserver
+    // la rangée précédente et la première rangée (pour le tore) ;
+    // avec une bordure morte, ces deux rangées sont vides
+    if (Boundary::DEAD) {
+        memset(first, 0, sizeof(first));
+        memset(above, 0, sizeof(above));
+    } else {
+        memcpy(first, this->cells[0], sizeof(first));
+        memcpy(above, this->cells[H-1], sizeof(above));
+    }
+    memset(this->changed, 0, sizeof(this->changed));
+
+    for (y=0; y<H; y++) {
+        memcpy(row, this->cells[y], sizeof(row));
+        below = y == H-1 ? first : this->cells[y+1];
+
+        this->shiftWest(above, aw);
+        this->shiftEast(above, ae);
+        this->shiftWest(row, rw);
+        this->shiftEast(row, re);
+        this->shiftWest(below, bw);
+        this->shiftEast(below, be);
+
+        for (i=0; i<WORDS; i++) {
+            // additionneurs complets sur 32 cellules à la fois :
+            // on somme les 8 voisins en un compteur de 4 bits (s3 s2 s1 s0)
+            sa = aw[i] ^ above[i] ^ ae[i];
+            ca = (aw[i] & above[i]) | (ae[i] & (aw[i] ^ above[i]));
+            sb = rw[i] ^ re[i] ^ bw[i];
+            cb = (rw[i] & re[i]) | (bw[i] & (rw[i] ^ re[i]));
+            sc = below[i] ^ be[i];
+            cc = below[i] & be[i];
+            s0 = sa ^ sb ^ sc;
+            cd = (sa & sb) | (sc & (sa ^ sb));
+            t  = ca ^ cb ^ cc;
+            ce = (ca & cb) | (cc & (ca ^ cb));
+            s1 = t ^ cd;
+            cf = t & cd;
+            s2 = ce ^ cf;
+            s3 = ce & cf;
+            if (this->conway) {
+                // 3 voisins : naissance ou survie, 2 voisins : survie
+                this->cells[y][i] = s1 & ~s2 & (s0 | row[i]);
+            } else {
+                this->cells[y][i] = this->applyRule(row[i], s0, s1, s2, s3);
+            }
+        }
+        this->cells[y][WORDS-1] &= LAST_MASK;
+
+        this->updateAge(y, row);
+        memcpy(above, row, sizeof(above));
+    }
+}
+
+// n générations de suite, sur les plans de bits : seules les tuiles qui ont
+// changé en cours de route sont signalées
+template <uint8_t W, uint8_t H, class Boundary>
+void SwarAutomaton<W,H,Boundary>::step(uint16_t n) {
+    uint32_t seen[TILES_Y];
+    uint8_t ty;
+    memset(seen, 0, sizeof(seen));
+    while (n--) {
+        this->step();
+        for (ty=0; ty<TILES_Y; ty++) {
+            seen[ty] |= this->changed[ty];
+        }
+    }
+    memcpy(this->changed, seen, sizeof(seen));
+}
+
+// une génération ne se découpe pas : elle est calculée d'un bloc
+template <uint8_t W, uint8_t H, class Boundary>
+bool SwarAutomaton<W,H,Boundary>::stepRows(uint8_t) {
+    this->step();
+    return true;
+}
+
+template <uint8_t W, uint8_t H, class Boundary>
+bool SwarAutomaton<W,H,Boundary>::isPending() {
+    return false;
+}
+
+#endif
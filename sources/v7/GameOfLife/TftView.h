@@ -0,0 +1,196 @@
+#ifndef GAME_OF_LIFE_TFT_VIEW_H_
+#define GAME_OF_LIFE_TFT_VIEW_H_
+
+#include "bootstrap.h"
+
+// Vue alternative à AutomatonView : les cellules sont envoyées rangée par
+// rangée à l'écran (gb.tft), sans passer par l'image de gb.display, qui
+// est libérée. La mémoire de cette image revient ainsi à l'univers, qui
+// peut occuper les 160x128 pixels de l'écran.
+template <class Model>
+class TftView
+{
+    private:
+
+        static const Color PALETTE[];
+        static const uint8_t W = Model::WIDTH;
+        static const uint8_t H = Model::HEIGHT;
+        static const uint8_t TILE = Model::TILE;
+        static const uint8_t TILES_X = (W + TILE - 1) / TILE;
+        static const uint8_t SCALE = CellSize<W,H,TFT_WIDTH,TFT_HEIGHT>::PIXELS;
+        // fréquence du bus SPI de l'écran, en MHz
+        static const uint8_t SPI_MHZ = 24;
+        // bandeau des messages, au bas de l'écran
+        static const uint8_t BANNER = 7;
+
+        Model* model;
+        // la palette, octets permutés : l'écran attend le poids fort en premier
+        uint16_t colors[16];
+        // deux tampons de rangée : l'un est transmis par DMA pendant que
+        // l'autre se remplit
+        uint16_t lines[2][TFT_WIDTH];
+        uint8_t line;
+        bool pending;
+
+        void fill(uint8_t y, uint8_t x, uint8_t xsup, uint8_t lo, uint8_t hi);
+        void send(uint8_t y, uint8_t x, uint8_t xsup);
+        void drain();
+        void wait();
+
+    public:
+
+        TftView(Model* model);
+        static void claim();
+        void draw();
+        void drawChanges();
+        void drawCell(uint8_t x, uint8_t y);
+        void restore(int16_t u, int16_t v);
+        void print(const char* text);
+};
+
+template <class Model>
+const Color TftView<Model>::PALETTE[] = {BLACK, GREEN, LIGHTGREEN, WHITE, YELLOW, BEIGE, BROWN, ORANGE, RED, PINK, PURPLE, DARKBLUE, BLUE, LIGHTBLUE, GRAY, DARKGRAY};
+
+template <class Model>
+TftView<Model>::TftView(Model* model) : model(model), line(0), pending(false) {
+    uint16_t c;
+    uint8_t g;
+    for (g=0; g<16; g++) {
+        c = (uint16_t)PALETTE[g];
+        this->colors[g] = (c << 8) | (c >> 8);
+    }
+}
+
+// libère l'image de gb.display, que gb.update() recopierait sinon par-dessus
+// les rangées envoyées ; à appeler une fois, avant d'allouer l'univers, pour
+// qu'il dispose de la mémoire ainsi rendue (les menus empruntent ensuite
+// une image le temps de s'afficher, et les messages, que gb.gui.popup()
+// y peindrait, sont écrits directement à l'écran par print())
+template <class Model>
+void TftView<Model>::claim() {
+    if (gb.display.width()) {
+        gb.display.init(0, 0, ColorMode::rgb565);
+    }
+}
+
+// l'écran entier est réécrit : il n'y a rien à effacer au préalable
+template <class Model>
+void TftView<Model>::draw() {
+    uint8_t x,y,xsup,ysup,i;
+    // hors du rectangle englobant, les cellules sont noires sans être lues
+    this->model->getBounds(x, y, xsup, ysup);
+    for (i=0; i<H; i++) {
+        if (i >= y && i < ysup) {
+            this->fill(i, 0, W, x, xsup);
+        } else {
+            this->fill(i, 0, W, 0, 0);
+        }
+        this->send(i, 0, W);
+    }
+    this->wait();
+}
+
+// ne renvoie que les plages de tuiles modifiées par la dernière génération
+template <class Model>
+void TftView<Model>::drawChanges() {
+    uint8_t tx,txsup,ty,x,xsup,i,isup;
+    uint32_t m;
+    for (ty=0; ty*TILE<H; ty++) {
+        m = this->model->getChangedTiles(ty);
+        isup = (ty+1)*TILE < H ? (ty+1)*TILE : H;
+        for (tx=0; tx<TILES_X && (m >> tx); tx=txsup) {
+            for (; !((m >> tx) & 1); tx++);
+            for (txsup=tx; txsup<TILES_X && ((m >> txsup) & 1); txsup++);
+            x = tx*TILE;
+            xsup = txsup*TILE < W ? txsup*TILE : W;
+            for (i=ty*TILE; i<isup; i++) {
+                this->fill(i, x, xsup, x, xsup);
+                this->send(i, x, xsup);
+            }
+        }
+    }
+    this->wait();
+}
+
+// renvoie la seule cellule (x,y), comptée à partir de 0
+template <class Model>
+void TftView<Model>::drawCell(uint8_t x, uint8_t y) {
+    this->fill(y, x, x+1, x, x+1);
+    this->send(y, x, x+1);
+    this->wait();
+}
+
+// un pixel ne peut être renvoyé seul : c'est toute sa cellule qui l'est
+template <class Model>
+void TftView<Model>::restore(int16_t u, int16_t v) {
+    if (u >= 0 && u < W*SCALE && v >= 0 && v < H*SCALE) {
+        this->drawCell(u / SCALE, v / SCALE);
+    }
+}
+
+// écrit le message dans un bandeau noir au bas de l'écran, une fois les
+// rangées en cours de transfert parties
+template <class Model>
+void TftView<Model>::print(const char* text) {
+    this->wait();
+    gb.tft.setColor(BLACK);
+    gb.tft.fillRect(0, TFT_HEIGHT - BANNER, TFT_WIDTH, BANNER);
+    gb.tft.setColor(WHITE);
+    gb.tft.setCursor(1, TFT_HEIGHT - BANNER + 1);
+    gb.tft.print(text);
+}
+
+// prépare dans le tampon libre les cellules x à xsup-1 de la rangée y ;
+// seules celles de [lo,hi[ sont lues dans le modèle, les autres sont noires
+template <class Model>
+void TftView<Model>::fill(uint8_t y, uint8_t x, uint8_t xsup, uint8_t lo, uint8_t hi) {
+    uint16_t* p = this->lines[this->line];
+    uint16_t c;
+    uint8_t k;
+    for (; x<xsup; x++) {
+        c = x >= lo && x < hi ? this->colors[this->model->getCell(x+1, y+1) & 0xF] : this->colors[0];
+        for (k=0; k<SCALE; k++) {
+            *p++ = c;
+        }
+    }
+}
+
+// transmet le tampon préparé, répété sur les SCALE lignes de pixels de la
+// rangée y ; le transfert se poursuit pendant que l'on remplit l'autre
+template <class Model>
+void TftView<Model>::send(uint8_t y, uint8_t x, uint8_t xsup) {
+    uint16_t n = (xsup - x) * SCALE;
+    uint8_t k;
+    this->wait();
+    gb.tft.setAddrWindow(x*SCALE, y*SCALE, x*SCALE + n - 1, y*SCALE + SCALE - 1);
+    SPI.beginTransaction(SPISettings(SPI_MHZ * 1000000UL, MSBFIRST, SPI_MODE0));
+    gb.tft.dataMode();
+    for (k=0; k<SCALE; k++) {
+        if (k) {
+            this->drain();
+        }
+        gb.tft.sendBuffer(this->lines[this->line], n);
+    }
+    this->pending = true;
+    this->line ^= 1;
+}
+
+// attend que le DMA ait achevé tous les transferts lancés, d'après les
+// descripteurs que la bibliothèque lui rend à la fin de chacun
+template <class Model>
+void TftView<Model>::drain() {
+    Gamebuino_Meta::wait_for_transfers_done();
+}
+
+// attend la fin du transfert en cours et rend l'écran
+template <class Model>
+void TftView<Model>::wait() {
+    if (this->pending) {
+        this->drain();
+        gb.tft.idleMode();
+        SPI.endTransaction();
+        this->pending = false;
+    }
+}
+
+#endif
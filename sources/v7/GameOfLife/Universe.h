@@ -0,0 +1,70 @@
+#ifndef GAME_OF_LIFE_UNIVERSE_H_
+#define GAME_OF_LIFE_UNIVERSE_H_
+
+#include "Automaton.h"
+#include "SwarAutomaton.h"
+#include "HashLife.h"
+#include "PlaneAutomaton.h"
+#include "AutomatonView.h"
+#include "TftView.h"
+#include "Editor.h"
+#include "EditorView.h"
+
+// L'univers simulé par le jeu : ses dimensions, sa topologie (Torus ou
+// DeadBorder) et son moteur. Automaton peut en changer en cours de partie,
+// depuis le menu, et propose aussi KleinBottle, Cylinder et Mirror ; les
+// autres moteurs gardent celle de leur compilation. Un quatrième paramètre
+// d'Automaton choisit le voisinage : Moore (par défaut), VonNeumann ou
+// Hexagonal, dont les rangées impaires sont affichées décalées d'une
+// demi-cellule : ce décalage n'existe qu'à partir de 2 pixels par cellule,
+// et une grille hexagonale de plus de 40x32 cellules s'affiche donc comme
+// une grille carrée (UNIVERSE_HEX en donne une de 40x32). SwarAutomaton
+// expose la même interface qu'Automaton et peut lui être substitué : la
+// grille passe alors d'un octet à deux bits par cellule, l'un pour la vie,
+// l'autre pour l'âge (nouvelle ou non).
+// HashLife, qui ne conserve pas l'âge des cellules, permet en outre de
+// sauter 2^k générations d'un coup avec jump(k). PlaneAutomaton<W, H, N>
+// simule un plan sans bord, dans une réserve de N morceaux de 16x16
+// cellules, dont l'écran n'est qu'une fenêtre déplacée avec la croix.
+// Les grilles de 40x32 cellules ou moins sont affichées agrandies.
+// Avec TftView comme vue (UNIVERSE_TFT), l'univers est envoyé rangée par
+// rangée à l'écran, sans image de 80x64 pixels en mémoire : un
+// SwarAutomaton de 160x128 cellules (2 x 2,5 Ko) occupe alors l'écran
+// pixel pour pixel.
+//
+// Le moteur est choisi à la compilation, en donnant à UNIVERSE l'une des
+// valeurs ci-dessous (ici ou avec -DUNIVERSE=...).
+#define UNIVERSE_AUTOMATON 0
+#define UNIVERSE_SWAR      1
+#define UNIVERSE_HASHLIFE  2
+#define UNIVERSE_PLANE     3
+#define UNIVERSE_TFT       4
+#define UNIVERSE_HEX       5
+
+#ifndef UNIVERSE
+#define UNIVERSE UNIVERSE_AUTOMATON
+#endif
+
+#if UNIVERSE == UNIVERSE_SWAR
+typedef SwarAutomaton<80, 64, Torus> Universe;
+#elif UNIVERSE == UNIVERSE_HASHLIFE
+typedef HashLife<80, 64, Torus> Universe;
+#elif UNIVERSE == UNIVERSE_PLANE
+typedef PlaneAutomaton<80, 64, 96> Universe;
+#elif UNIVERSE == UNIVERSE_TFT
+typedef SwarAutomaton<160, 128, Torus> Universe;
+#elif UNIVERSE == UNIVERSE_HEX
+typedef Automaton<40, 32, Torus, Hexagonal> Universe;
+#else
+typedef Automaton<80, 64, Torus> Universe;
+#endif
+
+#if UNIVERSE == UNIVERSE_TFT
+typedef TftView<Universe> UniverseView;
+#else
+typedef AutomatonView<Universe> UniverseView;
+#endif
+typedef Editor<Universe::WIDTH, Universe::HEIGHT, Universe::Topology> UniverseEditor;
+typedef EditorView<UniverseEditor, UniverseView> UniverseEditorView;
+
+#endif
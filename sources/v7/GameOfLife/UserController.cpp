@@ -7,6 +7,9 @@ const char* UserController::MAIN_MENU[] = {
     "EDIT",
     "RANDOMIZE",
     "PATTERNS",
+    "RULES",
+    "TOPOLOGY",
+    "FAST FORWARD",
     "EXIT"
 };
 
@@ -18,7 +21,98 @@ const char* UserController::PATTERN_MENU[] = {
     "EXIT"
 };
 
-UserController::UserController(GameController* gameController) : gameController(gameController) {
+const char* UserController::RULE_MENU[] = {
+    "CONWAY",
+    "HIGHLIFE",
+    "SEEDS",
+    "DAY & NIGHT",
+    "MAZE",
+    "BRIAN'S BRAIN",
+    "STAR WARS",
+    "BOSCO",
+    "MAJORITY",
+    "TLIFE",
+    "EXIT"
+};
+
+const char* UserController::RULES[] = {
+    Rule::CONWAY,
+    "B36/S23",
+    "B2/S",
+    "B3678/S34678",
+    "B3/S12345",
+    "/2/3",
+    "345/2/4",
+    "R5,C0,M1,S34..58,B34..45,NM",
+    "R4,C0,M1,S41..81,B41..81,NM",
+    "B3/S2-i34q"
+};
+
+const char* UserController::TOPOLOGY_MENU[] = {
+    "TORUS",
+    "KLEIN BOTTLE",
+    "CYLINDER",
+    "DEAD BORDER",
+    "MIRROR",
+    "EXIT"
+};
+
+const uint8_t UserController::TOPOLOGIES[] = {
+    Torus::ID,
+    KleinBottle::ID,
+    Cylinder::ID,
+    DeadBorder::ID,
+    Mirror::ID
+};
+
+const char* UserController::FORWARD_MENU[] = {
+    "10 GENERATIONS",
+    "100 GENERATIONS",
+    "1000 GENERATIONS",
+    "EXIT"
+};
+
+const uint16_t UserController::FORWARDS[] = {
+    10,
+    100,
+    1000
+};
+
+const char* UserController::SOUP_MENU[] = {
+    "50% DENSITY",
+    "25% DENSITY",
+    "C2 SYMMETRY",
+    "C4 SYMMETRY",
+    "D4 SYMMETRY",
+    "SAME SOUP",
+    "EXIT"
+};
+
+const uint8_t UserController::SOUP_DENSITIES[] = {
+    Soup::DENSITY,
+    Soup::DENSITY / 2,
+    Soup::DENSITY,
+    Soup::DENSITY,
+    Soup::DENSITY
+};
+
+const uint8_t UserController::SOUP_SYMMETRIES[] = {
+    Soup::NONE,
+    Soup::NONE,
+    Soup::C2,
+    Soup::C4,
+    Soup::D4
+};
+
+// déplacement de la fenêtre sur un univers plus grand que l'écran
+const uint8_t UserController::PAN_STEP = 8;
+
+// durée d'affichage des messages, en images
+const uint8_t UserController::POPUP_DURATION = 50;
+
+char UserController::text[20];
+
+UserController::UserController(GameController* gameController) : gameController(gameController), message(NULL), popupFrames(0) {
 
 }
 
@@ -59,6 +153,31 @@ void UserController::checkButtons() {
 
         if (gb.buttons.pressed(BUTTON_B)) {
             gc->stop();
+        } else if (gb.buttons.repeat(BUTTON_UP, 4)) {
+            gc->faster();
+        } else if (gb.buttons.repeat(BUTTON_DOWN, 4)) {
+            gc->slower();
+        } else if (gb.buttons.pressed(BUTTON_A)) {
+            // durée mesurée d'une génération, pour comparer les moteurs
+            // sur la console
+            sprintf(text, "%lu US/GEN", (unsigned long)gc->getCost());
+            this->notify(text);
+        }
+
+    }
+
+    // pendant la simulation, la croix règle la vitesse : l'univers ne se
+    // déplace qu'à l'arrêt
+    if (gc->isWaiting()) {
+
+        if (gb.buttons.repeat(BUTTON_UP, 2)) {
+            gc->pan(0, -PAN_STEP);
+        } else if (gb.buttons.repeat(BUTTON_DOWN, 2)) {
+            gc->pan(0, PAN_STEP);
+        } else if (gb.buttons.repeat(BUTTON_LEFT, 2)) {
+            gc->pan(-PAN_STEP, 0);
+        } else if (gb.buttons.repeat(BUTTON_RIGHT, 2)) {
+            gc->pan(PAN_STEP, 0);
         }
 
     }
@@ -67,7 +186,15 @@ void UserController::checkButtons() {
 void UserController::openMainMenu() {
     GameController* gc = this->gameController;
     gc->stop();
-    
+
+    // si l'univers est envoyé directement à l'écran (TftView), les menus
+    // ont besoin d'une image, empruntée le temps de les afficher
+    bool borrowed = !gb.display.width();
+    if (borrowed) {
+        gb.display.init(SCREEN_WIDTH, SCREEN_HEIGHT, ColorMode::index);
+    }
+
+
     uint8_t selected = gb.gui.menu("SELECT AN OPTION:", MAIN_MENU);
 
     switch (selected) {
@@ -78,13 +205,25 @@ void UserController::openMainMenu() {
             gc->startEdit();
             break;
         case 2:
-            gc->randomize();
+            this->openSoupMenu();
             break;
         case 3:
             this->openPatternMenu();
             break;
+        case 4:
+            this->openRuleMenu();
+            break;
+        case 5:
+            this->openTopologyMenu();
+            break;
+        case 6:
+            this->openForwardMenu();
+            break;
     }
 
+    if (borrowed) {
+        gb.display.init(0, 0, ColorMode::rgb565);
+    }
     gc->update();
 }
 
@@ -112,4 +251,64 @@ void UserController::openPatternMenu() {
             gc->addPattern(Pattern::GAMEBUINO, 16, 27);
             break;
     }
-}
\ No newline at end of file
+}
+
+void UserController::openRuleMenu() {
+    uint8_t selected = gb.gui.menu("SELECT A RULE:", RULE_MENU);
+
+    if (selected != 10 && !this->gameController->setRule(RULES[selected])) {
+        this->notify("RULE REFUSED");
+    }
+}
+
+// la grille est conservée : seul le voisinage des bords change
+void UserController::openTopologyMenu() {
+    uint8_t selected = gb.gui.menu("SELECT A TOPOLOGY:", TOPOLOGY_MENU);
+
+    if (selected != 5 && !this->gameController->setTopology(TOPOLOGIES[selected])) {
+        this->notify("TOPOLOGY REFUSED");
+    }
+}
+
+void UserController::openForwardMenu() {
+    uint8_t selected = gb.gui.menu("FAST FORWARD:", FORWARD_MENU);
+
+    if (selected != 3) {
+        this->gameController->fastForward(FORWARDS[selected]);
+    }
+}
+
+void UserController::openSoupMenu() {
+    uint8_t selected = gb.gui.menu("SELECT A SOUP:", SOUP_MENU);
+
+    if (selected == 6) {
+        return;
+    }
+    if (selected == 5) {
+        this->gameController->replay();
+    } else {
+        this->gameController->randomize(SOUP_DENSITIES[selected], SOUP_SYMMETRIES[selected]);
+    }
+    // la graine permet de retrouver la soupe, ici ou sur un PC
+    sprintf(text, "SEED %lu", (unsigned long)this->gameController->getSeed());
+    this->notify(text);
+}
+
+void UserController::notify(const char* text) {
+    this->message = text;
+    this->popupFrames = POPUP_DURATION;
+}
+
+// le message est peint par la vue de l'univers, après la mise à jour de
+// celui-ci, à chaque image ; l'univers n'étant repeint que là où il change,
+// il est redessiné en entier quand le message disparaît
+void UserController::showMessage() {
+    if (!this->popupFrames) {
+        return;
+    }
+    if (--this->popupFrames) {
+        this->gameController->print(this->message);
+    } else {
+        this->gameController->update();
+    }
+}
@@ -2,6 +2,9 @@
 #define GAME_OF_LIFE_USER_CONTROLLER_H_
 
 #include "Pattern.h"
+#include "Rule.h"
+#include "Boundary.h"
+#include "Soup.h"
 
 // Forward declaration
 class GameController;
@@ -12,18 +15,40 @@ class UserController
 
         static const char* MAIN_MENU[];
         static const char* PATTERN_MENU[];
+        static const char* RULE_MENU[];
+        static const char* RULES[];
+        static const char* TOPOLOGY_MENU[];
+        static const uint8_t TOPOLOGIES[];
+        static const char* FORWARD_MENU[];
+        static const uint16_t FORWARDS[];
+        static const char* SOUP_MENU[];
+        static const uint8_t SOUP_DENSITIES[];
+        static const uint8_t SOUP_SYMMETRIES[];
+        static const uint8_t PAN_STEP;
+        static const uint8_t POPUP_DURATION;
+        // le message garde le pointeur sur son texte
+        static char text[];
         
         GameController* gameController;
+        // message en cours et images pendant lesquelles il reste affiché
+        const char* message;
+        uint8_t popupFrames;
 
         void checkButtons();
+        void notify(const char* text);
         void openMainMenu();
         void openPatternMenu();
+        void openRuleMenu();
+        void openTopologyMenu();
+        void openForwardMenu();
+        void openSoupMenu();
 
     public:
 
         UserController(GameController* gameController);
         void begin();
         void loop();
+        void showMessage();
 };
 
 #endif
\ No newline at end of file
@@ -3,7 +3,21 @@
 
 #include <Gamebuino-Meta.h>
 
-const uint8_t W = 80;
-const uint8_t H = 64;
+const uint8_t SCREEN_WIDTH  = 80;
+const uint8_t SCREEN_HEIGHT = 64;
 
-#endif
\ No newline at end of file
+// définition réelle de l'écran, adressé directement par gb.tft
+const uint8_t TFT_WIDTH  = 160;
+const uint8_t TFT_HEIGHT = 128;
+
+// taille en pixels du côté d'une cellule, pour que W x H cellules
+// occupent le plus de place possible sur une surface de SW x SH pixels
+template <uint8_t W, uint8_t H, uint8_t SW = SCREEN_WIDTH, uint8_t SH = SCREEN_HEIGHT>
+struct CellSize
+{
+    static const uint8_t SX = SW / W;
+    static const uint8_t SY = SH / H;
+    static const uint8_t PIXELS = SX < SY ? (SX ? SX : 1) : (SY ? SY : 1);
+};
+
+#endif
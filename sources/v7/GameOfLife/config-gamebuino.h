@@ -0,0 +1,9 @@
+#ifndef GAME_OF_LIFE_CONFIG_GAMEBUINO_H_
+#define GAME_OF_LIFE_CONFIG_GAMEBUINO_H_
+
+// lu par la bibliothèque Gamebuino-Meta : gb.display est une image de
+// 80x64 pixels de 4 bits, indices dans la palette, que les vues écrivent
+// directement (2,5 Ko au lieu des 10 Ko du mode RGB565 par défaut)
+#define DISPLAY_MODE DISPLAY_MODE_INDEX
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef GAME_OF_LIFE_TESTS_GAMEBUINO_META_H_
+#define GAME_OF_LIFE_TESTS_GAMEBUINO_META_H_
+
+// Remplace la bibliothèque Gamebuino-Meta pour compiler les moteurs de
+// l'univers sur PC : ils n'en utilisent que les en-têtes standard qu'elle
+// inclut (via Arduino.h). AutomatonView n'a besoin que de l'image de
+// gb.display, toujours indexée ici, dont le tampon est déclaré comme dans
+// la bibliothèque (mots de 16 bits) ; seuls les rectangles y sont peints,
+// le texte est ignoré. Les contrôleurs ne sont pas testés.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+inline long random(long a, long b) {
+    return a + rand() % (b - a);
+}
+
+inline long random(long b) {
+    return rand() % b;
+}
+
+typedef uint16_t Color;
+
+const Color BLACK = 0, GREEN = 1, LIGHTGREEN = 2, WHITE = 3, YELLOW = 4,
+            BEIGE = 5, BROWN = 6, ORANGE = 7, RED = 8, PINK = 9, PURPLE = 10,
+            DARKBLUE = 11, BLUE = 12, LIGHTBLUE = 13, GRAY = 14, DARKGRAY = 15;
+
+namespace Gamebuino_Meta {
+
+class Image
+{
+    public:
+
+        uint16_t* _buffer;
+        uint16_t _width, _height;
+        Color color;
+
+        // w x h pixels de 4 bits
+        void init(uint16_t w, uint16_t h) {
+            free(this->_buffer);
+            this->_width = w;
+            this->_height = h;
+            this->_buffer = (uint16_t*)calloc((w * h + 3) / 4, sizeof(uint16_t));
+        }
+
+        uint16_t width() {
+            return this->_width;
+        }
+
+        uint16_t height() {
+            return this->_height;
+        }
+
+        void setPalette(Color* palette) {
+
+        }
+
+        void setColor(Color c) {
+            this->color = c;
+        }
+
+        void fillRect(int16_t x, int16_t y, int16_t w, int16_t h) {
+            uint8_t* p = (uint8_t*)this->_buffer;
+            int16_t u,v;
+            for (v=y; v<y+h; v++) {
+                for (u=x; u<x+w; u++) {
+                    uint8_t& b = p[(v*this->_width + u) / 2];
+                    b = u & 1 ? (b & 0xF0) | this->color : (b & 0x0F) | (this->color << 4);
+                }
+            }
+        }
+
+        void setCursor(int16_t x, int16_t y) {
+
+        }
+
+        void print(const char* text) {
+
+        }
+};
+
+class Gamebuino
+{
+    public:
+
+        Image display;
+};
+
+}
+
+extern Gamebuino_Meta::Gamebuino gb;
+
+#endif
@@ -0,0 +1,523 @@
+// Tests de non-régression des moteurs de l'univers, sur PC : chaque moteur
+// est comparé à Automaton (ou à une référence naïve) sur plusieurs règles,
+// topologies et chemins de calcul. Le programme renvoie 1 en cas d'écart.
+
+#include "Automaton.h"
+#include "SwarAutomaton.h"
+#include "HashLife.h"
+#include "PlaneAutomaton.h"
+#include "Editor.h"
+#include "Pattern.h"
+
+// les trois premières règles restent bornées, ce que suppose testPlane()
+static const char* RULES[] = {"B3/S23", "B36/S23", "B3678/S34678", "B2/S"};
+static const uint8_t RULE_COUNT = 4;
+static const uint8_t BOUNDED_RULES = 3;
+
+// règles suivies par la référence, sur chaque topologie : voisinage de
+// Moore (Life, Generations, lettres de Hensel), puis Larger than Life
+static const char* MOORE_RULES[] = {"B3/S23", "B36/S23", "B2-a/S12", "B2ce3ai/S23-k", "345/2/4", "125/36/5", "23/3ai/5"};
+static const uint8_t MOORE_COUNT = 7;
+static const char* LARGE_RULES[] = {"R5,C0,M1,S30..60,B30..45,NM", "R3,C0,M0,S5..9,B7..9,NN", "R2,C4,M1,S3..7,B4..6,NM", "R7,C0,M1,S30..60,B30..45,NN"};
+static const uint8_t LARGE_COUNT = 4;
+
+static int failures = 0;
+
+static void report(const char* name, const char* rule, int bad) {
+    printf("%-36s %-14s %s\n", name, rule, bad ? "FAIL" : "ok");
+    if (bad) {
+        failures++;
+    }
+}
+
+// nombre de cellules dont la vie diffère entre a (décalé de dx,dy) et b
+template <class A, class B>
+int diffLive(A& a, B& b, int dx = 0, int dy = 0) {
+    int bad = 0;
+    size_t x,y;
+    for (y=1; y<=B::HEIGHT; y++) {
+        for (x=1; x<=B::WIDTH; x++) {
+            bad += (a.getCell(x+dx, y+dy) != 0) != (b.getCell(x, y) != 0);
+        }
+    }
+    return bad;
+}
+
+// nombre de cellules dont la couleur diffère : b ne distingue que les
+// états 0 à top, au-delà desquels a est ramené à top (2 pour les âges de
+// SwarAutomaton, 1 pour PlaneAutomaton)
+template <class A, class B>
+int diffStates(A& a, B& b, uint8_t top, int dx = 0, int dy = 0) {
+    int bad = 0;
+    uint8_t g;
+    size_t x,y;
+    for (y=1; y<=B::HEIGHT; y++) {
+        for (x=1; x<=B::WIDTH; x++) {
+            g = a.getCell(x+dx, y+dy);
+            bad += (g < top ? g : top) != b.getCell(x, y);
+        }
+    }
+    return bad;
+}
+
+// une cellule modifiée doit l'être dans une tuile marquée
+template <class M>
+int missedTiles(M& m, uint8_t* before) {
+    int bad = 0;
+    size_t x,y;
+    for (y=0; y<M::HEIGHT; y++) {
+        for (x=0; x<M::WIDTH; x++, before++) {
+            if (*before != m.getCell(x+1, y+1) && !((m.getChangedTiles(y/8) >> (x/8)) & 1)) {
+                bad++;
+            }
+        }
+    }
+    return bad;
+}
+
+template <class M>
+void snapshot(M& m, uint8_t* cells) {
+    size_t x,y;
+    for (y=1; y<=M::HEIGHT; y++) {
+        for (x=1; x<=M::WIDTH; x++) {
+            *cells++ = m.getCell(x, y);
+        }
+    }
+}
+
+// Référence naïve : chaque cellule est réévaluée d'après son voisinage
+// (Moore, von Neumann, hexagonal, ou carré et losange de Larger than
+// Life), lu au-delà des bords selon l'une des cinq topologies, et suit
+// les transitions d'Automaton (âges jusqu'à 15, ou déclin des règles
+// Generations). Le voisinage de Moore passe par la table de la règle, qui
+// porte aussi les lettres de Hensel.
+template <uint8_t W, uint8_t H>
+struct Reference
+{
+    uint8_t cells[H][W];
+    // prolongement des colonnes et des rangées (Boundary.h)
+    uint8_t columns, rows;
+    // voisinage 3x3 (ID d'une structure de Neighbourhood.h)
+    char kernel;
+
+    void use(uint8_t topology) {
+        static const uint8_t EDGES[][2] = {
+            {Torus::COLUMNS, Torus::ROWS},
+            {KleinBottle::COLUMNS, KleinBottle::ROWS},
+            {Cylinder::COLUMNS, Cylinder::ROWS},
+            {DeadBorder::COLUMNS, DeadBorder::ROWS},
+            {Mirror::COLUMNS, Mirror::ROWS}
+        };
+        this->columns = EDGES[topology][0];
+        this->rows = EDGES[topology][1];
+    }
+
+    // cellule (x,y), comptée à partir de 0 : au-delà du haut ou du bas, la
+    // rangée désignée peut être retournée, avant de passer les côtés
+    uint8_t at(int x, int y) {
+        if (y < 0 || y >= H) {
+            if (this->rows == EDGE_DEAD) {
+                return 0;
+            } else if (this->rows == EDGE_REFLECT) {
+                y = y < 0 ? -1-y : 2*H-1 - y;
+            } else {
+                x = this->rows == EDGE_FLIP ? W-1 - x : x;
+                y = (y + H) % H;
+            }
+        }
+        if (x < 0 || x >= W) {
+            if (this->columns == EDGE_DEAD) {
+                return 0;
+            } else if (this->columns == EDGE_REFLECT) {
+                x = x < 0 ? -1-x : 2*W-1 - x;
+            } else {
+                x = (x + W) % W;
+            }
+        }
+        return this->cells[y][x];
+    }
+
+    // seules les cellules actives comptent parmi les voisines : toutes les
+    // cellules vivantes, ou celles de l'état 1 avec les règles Generations
+    uint8_t active(Rule& rule, int x, int y) {
+        uint8_t g = this->at(x, y);
+        return rule.getStates() > 2 ? g == 1 : g != 0;
+    }
+
+    bool alive(Rule& rule, int x, int y) {
+        const int R = rule.getRadius();
+        bool on = this->active(rule, x, y);
+        uint8_t lo,hi;
+        int n = 0;
+        int dx,dy,side;
+        if (rule.isLarge()) {
+            for (dy=-R; dy<=R; dy++) {
+                for (dx=-R; dx<=R; dx++) {
+                    if ((dx || dy) && (!rule.isVonNeumann() || abs(dx) + abs(dy) <= R)) {
+                        n += this->active(rule, x+dx, y+dy);
+                    }
+                }
+            }
+            if (on) {
+                rule.getSurvivalRange(lo, hi);
+            } else {
+                rule.getBirthRange(lo, hi);
+            }
+            return n >= lo && n <= hi;
+        }
+        if (this->kernel == VonNeumann::ID) {
+            n = this->active(rule, x, y-1) + this->active(rule, x-1, y)
+              + this->active(rule, x+1, y) + this->active(rule, x, y+1);
+        } else if (this->kernel == Hexagonal::ID) {
+            side = y & 1 ? 1 : -1;
+            n = this->active(rule, x, y-1) + this->active(rule, x+side, y-1)
+              + this->active(rule, x-1, y) + this->active(rule, x+1, y)
+              + this->active(rule, x, y+1) + this->active(rule, x+side, y+1);
+        } else {
+            // configuration 3x3, colonne par colonne, la cellule au bit 4
+            for (dx=-1; dx<=1; dx++) {
+                for (dy=-1; dy<=1; dy++) {
+                    n |= this->active(rule, x+dx, y+dy) << ((dx+1)*3 + dy+1);
+                }
+            }
+            return (rule.getTable()[n >> 3] >> (n & 7)) & 1;
+        }
+        return ((on ? rule.getSurvival() : rule.getBirth()) >> n) & 1;
+    }
+
+    void step(Rule& rule) {
+        const uint8_t S = rule.getStates();
+        uint8_t next[H][W];
+        uint8_t g;
+        int x,y;
+        bool on;
+        for (y=0; y<H; y++) {
+            for (x=0; x<W; x++) {
+                g = this->cells[y][x];
+                on = this->alive(rule, x, y);
+                if (S == 2) {
+                    g = on ? (g < 15 ? g+1 : 15) : 0;
+                } else if (g < 2) {
+                    g = on ? 1 : g == 1 ? 2 : 0;
+                } else {
+                    g = g+1 < S ? g+1 : 0;
+                }
+                next[y][x] = g;
+            }
+        }
+        memcpy(this->cells, next, sizeof(next));
+    }
+
+    uint8_t getCell(size_t x, size_t y) {
+        return this->cells[y-1][x-1];
+    }
+};
+
+// même soupe, mêmes cellules vivantes, même âge 1 des nouvelles cellules
+void testSoup() {
+    static Automaton<80,64,Torus> a, b;
+    static SwarAutomaton<80,64,Torus> s;
+    static HashLife<80,64,Torus> h;
+    static PlaneAutomaton<80,64,96> p;
+    uint32_t bits[2][64][3];
+    int bad = 0;
+    size_t x,y;
+    Soup s1(42, 100, Soup::NONE), s2(42, 100, Soup::NONE);
+    s1.fill(bits[0][0], 80, 64);
+    s2.fill(bits[1][0], 80, 64);
+    bad += memcmp(bits[0], bits[1], sizeof(bits[0])) != 0;
+
+    Soup d1(99, 100, Soup::D4), d2(99, 100, Soup::D4), d3(99, 100, Soup::D4), d4(99, 100, Soup::D4), d5(99, 100, Soup::D4);
+    a.randomize(d1);
+    b.randomize(d2);
+    s.randomize(d3);
+    h.randomize(d4);
+    p.randomize(d5);
+    for (y=1; y<=64; y++) {
+        for (x=1; x<=80; x++) {
+            bad += a.getCell(x, y) != b.getCell(x, y);
+            bad += (a.getCell(x, y) == 1) != (s.getCell(x, y) == 1);
+            bad += (a.getCell(x, y) != 0) != (a.getCell(81-x, y) != 0);
+            bad += (a.getCell(x, y) != 0) != (a.getCell(x, 65-y) != 0);
+        }
+    }
+    bad += diffLive(a, s) + diffLive(a, h) + diffLive(a, p);
+    report("soup: seed, symmetry, engines", "", bad);
+}
+
+// SwarAutomaton : vie, cellules nouvelles et tuiles modifiées
+template <class Boundary>
+void testSwar(const char* name, const char* rule) {
+    static Automaton<80,64,Boundary> a;
+    static SwarAutomaton<80,64,Boundary> s;
+    uint8_t before[64*80];
+    int bad = 0;
+    size_t g;
+    Soup s1(7, Soup::DENSITY, Soup::NONE), s2(7, Soup::DENSITY, Soup::NONE);
+    bad += !a.setRule(rule) + !s.setRule(rule);
+    a.randomize(s1);
+    s.randomize(s2);
+    for (g=0; g<200 && !bad; g++) {
+        snapshot(s, before);
+        a.step();
+        s.step();
+        bad += missedTiles(s, before);
+        bad += diffStates(a, s, 2);
+    }
+    report(name, rule, bad);
+}
+
+// HashLife sur un tore : pas simples, courts sauts et step(n)
+void testHashLife(const char* rule) {
+    static Automaton<100,37,Torus> a;
+    static HashLife<100,37,Torus> h;
+    int bad = 0;
+    size_t g,i;
+    Soup s1(12345, Soup::DENSITY, Soup::NONE), s2(12345, Soup::DENSITY, Soup::NONE);
+    bad += !a.setRule(rule) + !h.setRule(rule);
+    a.randomize(s1);
+    h.randomize(s2);
+    for (g=0; g<60 && !bad; g++) {
+        if (g % 3) {
+            a.step();
+            h.step();
+        } else {
+            for (i=0; i<7; i++) {
+                a.step();
+            }
+            h.step(7);
+        }
+        bad += diffLive(a, h);
+    }
+    a.step(100);
+    h.step(100);
+    bad += diffLive(a, h);
+    report("hashlife vs automaton, torus", rule, bad);
+}
+
+// quelques cellules sur un fond vide font passer Automaton au mode creux,
+// une soupe le ramène au mode dense : les deux suivent la référence
+void testSparse(const char* rule, uint8_t topology) {
+    static Automaton<80,64,Torus> a;
+    static Reference<80,64> r;
+    Rule parsed;
+    int bad = 0;
+    size_t g,x,y;
+    bad += !parsed.parse(rule) + !a.setRule(rule) + !a.setTopology(topology);
+    a.clear();
+    r.kernel = Moore::ID;
+    r.use(topology);
+    memset(r.cells, 0, sizeof(r.cells));
+    srand(topology + 1);
+    // un motif près du bord, pour traverser les coins
+    for (y=1; y<=6; y++) {
+        for (x=1; x<=6; x++) {
+            if (rand() % 3 == 0) {
+                a.spawn(x, y);
+                r.cells[y-1][x-1] = 1;
+            }
+        }
+    }
+    for (g=0; g<600 && !bad; g++) {
+        if (g == 300) {
+            for (y=20; y<44; y++) {
+                for (x=20; x<60; x++) {
+                    if (rand() % 2 == 0) {
+                        a.spawn(x, y);
+                        r.cells[y-1][x-1] = 1;
+                    }
+                }
+            }
+        }
+        a.step();
+        r.step(parsed);
+        bad += diffLive(r, a);
+    }
+    report(topology == DeadBorder::ID ? "sparse/dense vs reference, dead" : "sparse/dense vs reference, torus", rule, bad);
+}
+
+static const char* TOPOLOGIES[] = {"torus", "klein", "cylinder", "dead", "mirror"};
+
+// le moteur suit, état par état (couleur ramenée à top), la référence
+// partie de la même soupe, dans la topologie donnée
+template <class M>
+void testReference(const char* engine, const char* rule, uint8_t topology, uint8_t top) {
+    static M a;
+    static Reference<M::WIDTH,M::HEIGHT> r;
+    Rule parsed;
+    char name[40];
+    int bad = 0;
+    size_t g;
+    Soup soup(31 + topology, Soup::DENSITY, Soup::NONE);
+    bad += !parsed.parse(rule) + !a.setRule(rule) + !a.setTopology(topology);
+    r.kernel = M::Neighbourhood::ID;
+    r.use(topology);
+    a.randomize(soup);
+    snapshot(a, r.cells[0]);
+    for (g=0; g<80 && !bad; g++) {
+        a.step();
+        r.step(parsed);
+        bad += diffStates(r, a, top);
+    }
+    snprintf(name, sizeof(name), "%s vs reference, %s", engine, TOPOLOGIES[topology]);
+    report(name, rule, bad);
+}
+
+// une lettre de Hensel retient une forme du voisinage, et pas les autres
+void testLetters() {
+    static const char* RULES[] = {"B2e/S", "B2e/S", "B2-e/S", "B2-e/S", "B2a/S", "B2a/S"};
+    // voisines de la cellule (20,20) : nord et ouest (2e), nord et sud
+    // (2i), nord et nord-est (2a)
+    static const int8_t CELLS[][4] = {{0,-1,-1,0}, {0,-1,0,1}, {0,-1,-1,0}, {0,-1,0,1}, {0,-1,1,-1}, {0,-1,-1,0}};
+    static const uint8_t BORN[] = {1, 0, 0, 1, 1, 0};
+    static Automaton<40,40,Torus> a;
+    int bad = 0;
+    uint8_t i;
+    for (i=0; i<6; i++) {
+        bad += !a.setRule(RULES[i]);
+        a.clear();
+        a.spawn(20 + CELLS[i][0], 20 + CELLS[i][1]);
+        a.spawn(20 + CELLS[i][2], 20 + CELLS[i][3]);
+        a.step();
+        bad += (a.getCell(20, 20) != 0) != BORN[i];
+    }
+    report("hensel letters", "", bad);
+}
+
+// une génération étalée sur plusieurs appels à stepRows() aboutit à la
+// même grille et aux mêmes modifications que step()
+template <class M>
+void testStepRows(const char* rule, uint8_t topology) {
+    static M a, b;
+    int bad = 0;
+    size_t g,y,t,k;
+    Soup s1(21, Soup::DENSITY, Soup::NONE), s2(21, Soup::DENSITY, Soup::NONE);
+    bad += !a.setRule(rule) + !b.setRule(rule);
+    bad += !a.setTopology(topology) + !b.setTopology(topology);
+    a.randomize(s1);
+    b.randomize(s2);
+    for (g=0, k=0; g<150 && !bad; g++) {
+        a.step();
+        while (!b.stepRows(1 + k++ % 7));
+        for (y=1; y<=M::HEIGHT; y++) {
+            for (t=1; t<=M::WIDTH; t++) {
+                bad += a.getCell(t, y) != b.getCell(t, y);
+            }
+        }
+        for (y=0; y<M::HEIGHT; y++) {
+            if (y % 8 == 0) {
+                bad += a.getChangedTiles(y/8) != b.getChangedTiles(y/8);
+            }
+            for (t=0; t<(M::WIDTH+7)/8; t++) {
+                bad += a.getChangedCells(y, t) != b.getChangedCells(y, t);
+            }
+        }
+    }
+    report("stepRows vs step", rule, bad);
+}
+
+// la fenêtre du plan, déplacée ou non, suit un grand univers borné dont
+// les bords ne sont pas atteints
+void testPlane(const char* rule) {
+    static Automaton<250,250,DeadBorder> big;
+    static PlaneAutomaton<80,64,120> p;
+    const int OX = 85, OY = 93;
+    int bad = 0;
+    int g,x,y,dx,dy;
+    uint8_t before[64*80];
+    bad += !big.setRule(rule) + !p.setRule(rule);
+    big.clear();
+    p.clear();
+    srand(5);
+    for (y=20; y<44; y++) {
+        for (x=25; x<55; x++) {
+            if (rand() % 2) {
+                big.spawn(x+OX, y+OY);
+                p.spawn(x, y);
+            }
+        }
+    }
+    for (g=0; g<300 && !bad; g++) {
+        snapshot(p, before);
+        big.step();
+        p.step();
+        bad += missedTiles(p, before);
+        bad += diffStates(big, p, 1, OX, OY);
+        if (g % 37 == 0) {
+            dx = (g*7) % 40 - 20;
+            dy = (g*11) % 40 - 20;
+            p.pan(dx, dy);
+            bad += diffStates(big, p, 1, OX+dx, OY+dy);
+            p.pan(-dx, -dy);
+        }
+    }
+    report("plane vs dead border", rule, bad);
+}
+
+// le curseur suit la topologie choisie à l'exécution
+void testEditor() {
+    Editor<80,64,Torus> e(5, 1);
+    int bad = 0;
+    int i;
+    e.up();
+    bad += !(e.getX() == 5 && e.getY() == 64);
+    e.setTopology(KleinBottle::ID);
+    e.down();
+    bad += !(e.getX() == 76 && e.getY() == 1);
+    e.setTopology(Cylinder::ID);
+    e.up();
+    bad += e.getY() != 1;
+    for (i=0; i<10; i++) {
+        e.right();
+    }
+    bad += e.getX() != 6;
+    e.setTopology(DeadBorder::ID);
+    for (i=0; i<80; i++) {
+        e.right();
+    }
+    bad += e.getX() != 80;
+    e.setTopology(Mirror::ID);
+    e.right();
+    bad += e.getX() != 80;
+    bad += e.setTopology(0xFF);
+    report("editor wrap", "", bad);
+}
+
+int main() {
+    uint8_t i,j;
+    testSoup();
+    for (i=0; i<RULE_COUNT; i++) {
+        testSwar<Torus>("swar vs automaton, torus", RULES[i]);
+        testSwar<DeadBorder>("swar vs automaton, dead", RULES[i]);
+        testHashLife(RULES[i]);
+        testSparse(RULES[i], Torus::ID);
+        testSparse(RULES[i], DeadBorder::ID);
+        if (i < BOUNDED_RULES) {
+            testPlane(RULES[i]);
+        }
+    }
+    for (i=0; i<5; i++) {
+        testStepRows<Automaton<80,64,Torus> >(Rule::CONWAY, i);
+    }
+    testStepRows<Automaton<79,61,Torus> >("125/36/5", Torus::ID);
+    for (i=0; i<5; i++) {
+        for (j=0; j<MOORE_COUNT; j++) {
+            testReference<Automaton<37,30,Torus> >("automaton", MOORE_RULES[j], i, 15);
+        }
+        for (j=0; j<LARGE_COUNT; j++) {
+            testReference<Automaton<37,30,Torus> >("automaton", LARGE_RULES[j], i, 15);
+        }
+        testReference<Automaton<37,30,Torus,VonNeumann> >("von neumann", "B1/S013V", i, 15);
+        testReference<Automaton<37,30,Torus,VonNeumann> >("von neumann", "12/13/4V", i, 15);
+        testReference<Automaton<36,30,Torus,Hexagonal> >("hexagonal", "B2/S34H", i, 15);
+        testReference<Automaton<36,30,Torus,Hexagonal> >("hexagonal", "23/24/5H", i, 15);
+    }
+    for (j=0; j<RULE_COUNT; j++) {
+        testReference<SwarAutomaton<64,40,Torus> >("swar", RULES[j], Torus::ID, 2);
+        testReference<SwarAutomaton<64,40,DeadBorder> >("swar", RULES[j], DeadBorder::ID, 2);
+    }
+    testLetters();
+    testEditor();
+    printf("%d failure(s)\n", failures);
+    return failures != 0;
+}
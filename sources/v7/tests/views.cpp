@@ -0,0 +1,86 @@
+// Tests de AutomatonView sur PC : après un dessin complet comme après le
+// seul repeint des cellules modifiées, chaque pixel du tampon indexé de
+// gb.display porte l'état de la cellule qu'il représente.
+
+#include "Automaton.h"
+#include "SwarAutomaton.h"
+#include "AutomatonView.h"
+
+Gamebuino_Meta::Gamebuino gb;
+
+static int failures = 0;
+
+static void report(const char* name, const char* rule, int bad) {
+    printf("%-36s %-14s %s\n", name, rule, bad ? "FAIL" : "ok");
+    if (bad) {
+        failures++;
+    }
+}
+
+// pixels du tampon qui ne montrent pas leur cellule
+template <class M>
+int misdrawn(M& m, bool hex) {
+    const int S = CellSize<M::WIDTH,M::HEIGHT>::PIXELS;
+    uint8_t* p = (uint8_t*)gb.display._buffer;
+    int bad = 0;
+    int u,v,r,c,shift,want,got;
+    for (v=0; v<SCREEN_HEIGHT; v++) {
+        for (u=0; u<SCREEN_WIDTH; u++) {
+            r = v / S;
+            shift = hex && (r & 1) ? S / 2 : 0;
+            want = 0;
+            if (r < M::HEIGHT && u >= shift && (u - shift) / S < M::WIDTH) {
+                c = (u - shift) / S;
+                want = m.getCell(c+1, r+1) & 0xF;
+            }
+            got = u & 1 ? p[v*SCREEN_WIDTH/2 + u/2] & 0xF : p[v*SCREEN_WIDTH/2 + u/2] >> 4;
+            bad += got != want;
+        }
+    }
+    return bad;
+}
+
+template <class M>
+void testView(const char* name, const char* rule, bool hex) {
+    static M m;
+    AutomatonView<M> view(&m);
+    int bad = 0;
+    int g;
+    Soup soup(11, Soup::DENSITY, Soup::NONE);
+    bad += !m.setRule(rule);
+    m.randomize(soup);
+    memset(gb.display._buffer, 0x55, SCREEN_WIDTH * SCREEN_HEIGHT / 2);
+    view.draw();
+    bad += misdrawn(m, hex);
+    for (g=0; g<60 && !bad; g++) {
+        if (g % 17 == 5) {
+            m.spawn(3 + g % 20, 4);
+            view.drawCell(2 + g % 20, 3);
+            m.kill(5, 6);
+            view.drawCell(4, 5);
+        }
+        if (g % 23 == 7) {
+            m.step(3);
+        } else {
+            m.step();
+        }
+        view.drawChanges();
+        bad += misdrawn(m, hex);
+    }
+    // un message peint par-dessus disparaît au dessin complet suivant
+    view.print("RULE REFUSED");
+    view.draw();
+    bad += misdrawn(m, hex);
+    report(name, rule, bad);
+}
+
+int main() {
+    gb.display.init(SCREEN_WIDTH, SCREEN_HEIGHT);
+    testView<Automaton<80,64,Torus> >("automaton 80x64", Rule::CONWAY, false);
+    testView<Automaton<80,64,Torus> >("automaton 80x64", "/2/5", false);
+    testView<Automaton<79,61,DeadBorder> >("automaton 79x61", Rule::CONWAY, false);
+    testView<Automaton<40,32,Torus,Hexagonal> >("automaton 40x32 hexagonal", "B2/S34H", true);
+    testView<SwarAutomaton<80,64,Torus> >("swar 80x64", Rule::CONWAY, false);
+    printf("%d failure(s)\n", failures);
+    return failures != 0;
+}